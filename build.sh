@@ -102,9 +102,10 @@ function buildTests() {
     echo "Building tests..."
 
     cd src/tests
-    g++ test.cpp -o test
+    gcc -O2 -c ../vendor/zlib-1.3.1/{adler32,crc32,deflate,inffast,inflate,inftrees,trees,zutil,compress,uncompr}.c
+    g++ test.cpp *.o -o test
     ./test
-    rm test
+    rm test *.o
     cd ../..
 }
 
@@ -16,6 +16,7 @@ function AB.loadConfig()
         yScale = 1,
         fullscreen = false,
         vsync = true,
+        pipelined = false,
     }
 end
 
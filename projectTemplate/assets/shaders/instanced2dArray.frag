@@ -0,0 +1,52 @@
+in vec4 Color;
+in vec2 TexCoord;
+flat in int TextureUnit;
+flat in highp int TextureLayer;
+
+uniform mediump sampler2DArray textureSamplers[16];
+
+// this will eventually be in a uniform buffer object
+uniform mat4 colorTransform;
+
+out vec4 color;
+
+void main() {
+    vec3 texCoord = vec3(TexCoord, float(TextureLayer));
+
+    if (TextureUnit == 0) {
+        color = texture(textureSamplers[0], texCoord) * Color;
+    } else if (TextureUnit == 1) {
+        color = texture(textureSamplers[1], texCoord) * Color;
+    } else if (TextureUnit == 2) {
+        color = texture(textureSamplers[2], texCoord) * Color;
+    } else if (TextureUnit == 3) {
+        color = texture(textureSamplers[3], texCoord) * Color;
+    } else if (TextureUnit == 4) {
+        color = texture(textureSamplers[4], texCoord) * Color;
+    } else if (TextureUnit == 5) {
+        color = texture(textureSamplers[5], texCoord) * Color;
+    } else if (TextureUnit == 6) {
+        color = texture(textureSamplers[6], texCoord) * Color;
+    } else if (TextureUnit == 7) {
+        color = texture(textureSamplers[7], texCoord) * Color;
+    } else if (TextureUnit == 8) {
+        color = texture(textureSamplers[8], texCoord) * Color;
+    } else if (TextureUnit == 9) {
+        color = texture(textureSamplers[9], texCoord) * Color;
+    } else if (TextureUnit == 10) {
+        color = texture(textureSamplers[10], texCoord) * Color;
+    } else if (TextureUnit == 11) {
+        color = texture(textureSamplers[11], texCoord) * Color;
+    } else if (TextureUnit == 12) {
+        color = texture(textureSamplers[12], texCoord) * Color;
+    } else if (TextureUnit == 13) {
+        color = texture(textureSamplers[13], texCoord) * Color;
+    } else if (TextureUnit == 14) {
+        color = texture(textureSamplers[14], texCoord) * Color;
+    } else if (TextureUnit == 15) {
+        color = texture(textureSamplers[15], texCoord) * Color;
+    } else {
+        color = Color;
+    }
+    color = color * colorTransform;
+}
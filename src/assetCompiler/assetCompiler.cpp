@@ -34,6 +34,8 @@ freely, subject to the following restrictions:
 #include <sstream>
 #include <cstring>
 #include <cassert>
+#include <cmath>
+#include <map>
 
 extern "C" {
 #include "../vendor/lua-5.3.5/src/lua.h"
@@ -43,6 +45,10 @@ extern "C" {
 
 #include "../vendor/zlib-1.3.1/zlib.h"
 
+#include "../main/renderer/fontFormat.h"
+#include "../main/renderer/atlasFormat.h"
+#include "../main/renderer/textureFormat.h"
+
 #define CHUNK_SIZE 16384
 
 //  likely don't want this because it breaks cross-platform compatibility
@@ -51,6 +57,8 @@ extern "C" {
 
 lua_State* luaVM;
 std::string key;
+bool mipmaps = false;
+bool textureBlobs = false;
 
 template<class T>
 inline std::string toString(T val, bool groupDigits = true) {
@@ -112,6 +120,8 @@ struct Asset {
         fclose(file);
     }
 
+    Asset(std::string filename, uint8_t* data, uint64_t size) : filename(filename), data(data), size(size) {}
+
     ~Asset() {
         delete [] data;
     }
@@ -127,6 +137,575 @@ struct Asset {
 
 std::vector<Asset*> assets;
 
+bool endsWith(std::string const& s, std::string const& suffix) {
+    return s.length() >= suffix.length() && s.compare(s.length() - suffix.length(), suffix.length(), suffix) == 0;
+}
+
+//  turns a BMFont text descriptor into the engine's binary one (see fontFormat.h) so the
+//  engine doesn't have to parse it at load time
+bool compileFont(Asset* asset) {
+    if (asset->size >= sizeof(AB::FontHeader) && std::memcmp(asset->data, AB::FONT_MAGIC, sizeof(AB::FONT_MAGIC)) == 0) {
+        return true;
+    }
+
+    AB::FontHeader header;
+    std::memcpy(header.magic, AB::FONT_MAGIC, sizeof(AB::FONT_MAGIC));
+    header.version = AB::FONT_VERSION;
+    header.lineHeight = 0;
+    header.base = 0;
+    header.scaleW = 0;
+    header.scaleH = 0;
+
+    std::string pageName;
+    bool multiplePages = false;
+    std::vector<AB::FontGlyph> glyphs;
+    std::vector<AB::FontKerning> kernings;
+
+    std::string input(reinterpret_cast<char*>(asset->data), asset->size);
+    std::istringstream stream(input);
+    std::string line;
+    while (std::getline(stream, line)) {
+        std::istringstream lineStream(line);
+        std::string tag;
+        lineStream >> tag;
+        if (tag == "<?xml") {
+            std::cerr << "XML font files are not supported: " << asset->filename << std::endl;
+            return false;
+        }
+
+        std::string pair;
+        std::map<std::string, std::string> pairs;
+        while (lineStream >> pair) {
+            size_t i = pair.find('=');
+            if (i != std::string::npos) {
+                pairs[pair.substr(0, i)] = pair.substr(i + 1);
+            }
+        }
+
+        auto value = [&](const char* key) {
+            auto iterator = pairs.find(key);
+            return iterator == pairs.end() ? 0 : std::stoi(iterator->second);
+        };
+
+        if (tag == "common") {
+            header.lineHeight = value("lineHeight");
+            header.base = value("base");
+            header.scaleW = value("scaleW");
+            header.scaleH = value("scaleH");
+        } else if (tag == "page") {
+            if (!pageName.empty()) {
+                multiplePages = true;
+                continue;
+            }
+            //  the filename is quoted and may have spaces in it
+            size_t start = line.find("file=\"");
+            if (start != std::string::npos) {
+                start += 6;
+                pageName = line.substr(start, line.find('"', start) - start);
+            }
+        } else if (tag == "char") {
+            int id = value("id");
+            if (id < 0) {
+                continue;
+            }
+            AB::FontGlyph glyph;
+            glyph.id = id;
+            glyph.x = value("x");
+            glyph.y = value("y");
+            glyph.width = value("width");
+            glyph.height = value("height");
+            glyph.xOffset = value("xoffset");
+            glyph.yOffset = value("yoffset");
+            glyph.xAdvance = value("xadvance");
+            glyph.page = value("page");
+            glyphs.push_back(glyph);
+        } else if (tag == "kerning") {
+            int first = value("first");
+            int second = value("second");
+            if (first < 0 || second < 0) {
+                continue;
+            }
+            AB::FontKerning kerning;
+            kerning.first = first;
+            kerning.second = second;
+            kerning.amount = value("amount");
+            kernings.push_back(kerning);
+        }
+    }
+
+    if (multiplePages) {
+        std::cout << "WARNING: " << asset->filename << " has more than one page, only the first is used" << std::endl;
+    }
+
+    std::stable_sort(kernings.begin(), kernings.end(), [](const AB::FontKerning& a, const AB::FontKerning& b) {
+        return a.first != b.first ? a.first < b.first : a.second < b.second;
+    });
+
+    header.glyphCount = glyphs.size();
+    header.kerningCount = kernings.size();
+    header.pageNameLength = pageName.size();
+
+    uint64_t pageSize = (pageName.size() + 3) & ~3;
+    uint64_t size = sizeof(header) + pageSize + glyphs.size() * sizeof(AB::FontGlyph) + kernings.size() * sizeof(AB::FontKerning);
+    uint8_t* data = new uint8_t[size];
+    std::memset(data, 0, size);
+
+    uint8_t* p = data;
+    std::memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    std::memcpy(p, pageName.c_str(), pageName.size());
+    p += pageSize;
+    if (!glyphs.empty()) {
+        std::memcpy(p, glyphs.data(), glyphs.size() * sizeof(AB::FontGlyph));
+        p += glyphs.size() * sizeof(AB::FontGlyph);
+    }
+    if (!kernings.empty()) {
+        std::memcpy(p, kernings.data(), kernings.size() * sizeof(AB::FontKerning));
+    }
+
+    std::cout << "Compiled font " << asset->filename << ": " << glyphs.size() << " glyphs, " << kernings.size() << " kerning pairs, "
+        << toString(asset->size) << " -> " << toString(size) << " bytes" << std::endl;
+
+    delete [] asset->data;
+    asset->data = data;
+    asset->size = size;
+
+    return true;
+}
+
+//  reads TGA files. returns top down RGBA rows, not premultiplied
+bool decodeTGA(Asset* asset, std::vector<uint8_t>& pixels, uint32_t& width, uint32_t& height) {
+    const uint8_t* data = asset->data;
+    if (asset->size < 18 || data[1] != 0 || (data[2] != 2 && data[2] != 10)) {
+        std::cerr << "Unsupported TGA file: " << asset->filename << std::endl;
+        return false;
+    }
+
+    width = data[12] | (data[13] << 8);
+    height = data[14] | (data[15] << 8);
+    uint32_t pixelSize = data[16] / 8;
+    bool topDown = (data[17] & 0x20) != 0;
+    if (width == 0 || height == 0 || (pixelSize != 3 && pixelSize != 4)) {
+        std::cerr << "Unsupported TGA file: " << asset->filename << std::endl;
+        return false;
+    }
+
+    const uint8_t* current = data + 18 + data[0];
+    const uint8_t* end = data + asset->size;
+    uint32_t pixelCount = width * height;
+    std::vector<uint8_t> raw(pixelCount * pixelSize);
+
+    if (data[2] == 2) {
+        if (current + raw.size() > end) {
+            std::cerr << "Truncated TGA file: " << asset->filename << std::endl;
+            return false;
+        }
+        std::memcpy(raw.data(), current, raw.size());
+    } else {
+        uint32_t index = 0;
+        while (index < pixelCount) {
+            if (current >= end) {
+                std::cerr << "Truncated TGA file: " << asset->filename << std::endl;
+                return false;
+            }
+            uint8_t chunk = *current++;
+            uint32_t length = std::min<uint32_t>((chunk & 0x7F) + 1, pixelCount - index);
+            if (chunk & 0x80) {
+                if (current + pixelSize > end) {
+                    std::cerr << "Truncated TGA file: " << asset->filename << std::endl;
+                    return false;
+                }
+                for (uint32_t i = 0; i < length; i++, index++) {
+                    std::memcpy(&raw[index * pixelSize], current, pixelSize);
+                }
+                current += pixelSize;
+            } else {
+                if (current + length * pixelSize > end) {
+                    std::cerr << "Truncated TGA file: " << asset->filename << std::endl;
+                    return false;
+                }
+                std::memcpy(&raw[index * pixelSize], current, length * pixelSize);
+                current += length * pixelSize;
+                index += length;
+            }
+        }
+    }
+
+    pixels.resize(pixelCount * 4);
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* source = &raw[(topDown ? y : height - 1 - y) * width * pixelSize];
+        uint8_t* destination = &pixels[y * width * 4];
+        for (uint32_t x = 0; x < width; x++, source += pixelSize, destination += 4) {
+            destination[0] = source[2];
+            destination[1] = source[1];
+            destination[2] = source[0];
+            destination[3] = pixelSize == 4 ? source[3] : 255;
+        }
+    }
+
+    return true;
+}
+
+//  turns top down RGBA rows into a GPU ready texture (see textureFormat.h), premultiplied the
+//  same way the engine's TGA loader does it, plus box filtered mipmaps if they're wanted
+std::vector<uint8_t> buildTexture(std::vector<uint8_t> pixels, uint32_t width, uint32_t height) {
+    for (size_t i = 0; i < pixels.size(); i += 4) {
+        float a = pixels[i + 3] / 255.0f;
+        for (size_t c = 0; c < 3; c++) {
+            float value = pixels[i + c] / 255.0f;
+            value *= a;
+            pixels[i + c] = (uint8_t)std::round(value * 255.0f);
+        }
+    }
+
+    AB::TextureHeader header;
+    std::memcpy(header.magic, AB::TEXTURE_MAGIC, sizeof(AB::TEXTURE_MAGIC));
+    header.version = AB::TEXTURE_VERSION;
+    header.width = width;
+    header.height = height;
+    header.mipLevels = 1;
+    header.reserved = 0;
+    if (mipmaps) {
+        while ((width >> header.mipLevels) > 0 || (height >> header.mipLevels) > 0) {
+            header.mipLevels++;
+        }
+    }
+
+    std::vector<uint8_t> texture(sizeof(header));
+    std::memcpy(texture.data(), &header, sizeof(header));
+    texture.insert(texture.end(), pixels.begin(), pixels.end());
+
+    //  each level averages 2x2 blocks of the one before, clamping at odd edges
+    uint32_t levelWidth = width, levelHeight = height;
+    for (uint32_t level = 1; level < header.mipLevels; level++) {
+        uint32_t nextWidth = std::max(levelWidth / 2, 1U), nextHeight = std::max(levelHeight / 2, 1U);
+        std::vector<uint8_t> next(nextWidth * nextHeight * 4);
+        for (uint32_t y = 0; y < nextHeight; y++) {
+            uint32_t y0 = std::min(y * 2, levelHeight - 1), y1 = std::min(y * 2 + 1, levelHeight - 1);
+            for (uint32_t x = 0; x < nextWidth; x++) {
+                uint32_t x0 = std::min(x * 2, levelWidth - 1), x1 = std::min(x * 2 + 1, levelWidth - 1);
+                for (uint32_t c = 0; c < 4; c++) {
+                    uint32_t sum = pixels[(y0 * levelWidth + x0) * 4 + c] + pixels[(y0 * levelWidth + x1) * 4 + c] +
+                        pixels[(y1 * levelWidth + x0) * 4 + c] + pixels[(y1 * levelWidth + x1) * 4 + c];
+                    next[(y * nextWidth + x) * 4 + c] = (sum + 2) / 4;
+                }
+            }
+        }
+        texture.insert(texture.end(), next.begin(), next.end());
+        pixels.swap(next);
+        levelWidth = nextWidth;
+        levelHeight = nextHeight;
+    }
+
+    return texture;
+}
+
+void replaceData(Asset* asset, const std::vector<uint8_t>& data) {
+    delete [] asset->data;
+    asset->data = new uint8_t[data.size()];
+    std::memcpy(asset->data, data.data(), data.size());
+    asset->size = data.size();
+}
+
+//  swaps a TGA for a GPU ready texture under the same name, so the engine does no per pixel
+//  work loading it. TGAs the engine couldn't read either are left as they are. only done with
+//  --texture-blobs: for mostly flat sprite art the raw pixels take longer to inflate than the
+//  RLE takes to decode, so it only pays off for photo-like images
+void compileTexture(Asset* asset) {
+    if (asset->size >= sizeof(AB::TextureHeader) && std::memcmp(asset->data, AB::TEXTURE_MAGIC, sizeof(AB::TEXTURE_MAGIC)) == 0) {
+        return;
+    }
+
+    std::vector<uint8_t> pixels;
+    uint32_t width, height;
+    if (!decodeTGA(asset, pixels, width, height)) {
+        std::cout << "WARNING: " << asset->filename << " is left uncompiled" << std::endl;
+        return;
+    }
+
+    uint64_t originalSize = asset->size;
+    replaceData(asset, buildTexture(pixels, width, height));
+    std::cout << "Compiled texture " << asset->filename << ": " << width << "x" << height << ", "
+        << toString(originalSize) << " -> " << toString(asset->size) << " bytes" << std::endl;
+}
+
+struct AtlasRect {
+    uint32_t x, y, width, height;
+};
+
+//  MaxRects bin, placing by best short side fit
+struct AtlasPage {
+    AtlasPage(uint32_t size) {
+        freeRects.push_back({ 0, 0, size, size });
+    }
+
+    bool find(uint32_t width, uint32_t height, AtlasRect& rect, uint32_t& score) const {
+        bool found = false;
+        for (const auto& free : freeRects) {
+            if (free.width >= width && free.height >= height) {
+                uint32_t shortSide = std::min(free.width - width, free.height - height);
+                if (!found || shortSide < score) {
+                    rect = { free.x, free.y, width, height };
+                    score = shortSide;
+                    found = true;
+                }
+            }
+        }
+        return found;
+    }
+
+    void place(const AtlasRect& rect) {
+        std::vector<AtlasRect> split;
+        for (auto it = freeRects.begin(); it != freeRects.end();) {
+            const AtlasRect free = *it;
+            if (rect.x >= free.x + free.width || rect.x + rect.width <= free.x ||
+                rect.y >= free.y + free.height || rect.y + rect.height <= free.y) {
+                it++;
+                continue;
+            }
+
+            //  keep whatever is left on each side of the placed rectangle
+            if (rect.x > free.x) {
+                split.push_back({ free.x, free.y, rect.x - free.x, free.height });
+            }
+            if (rect.x + rect.width < free.x + free.width) {
+                split.push_back({ rect.x + rect.width, free.y, free.x + free.width - rect.x - rect.width, free.height });
+            }
+            if (rect.y > free.y) {
+                split.push_back({ free.x, free.y, free.width, rect.y - free.y });
+            }
+            if (rect.y + rect.height < free.y + free.height) {
+                split.push_back({ free.x, rect.y + rect.height, free.width, free.y + free.height - rect.y - rect.height });
+            }
+            it = freeRects.erase(it);
+        }
+        freeRects.insert(freeRects.end(), split.begin(), split.end());
+
+        //  drop free rectangles that sit inside another one
+        auto contains = [](const AtlasRect& a, const AtlasRect& b) {
+            return b.x >= a.x && b.y >= a.y && b.x + b.width <= a.x + a.width && b.y + b.height <= a.y + a.height;
+        };
+        for (size_t i = 0; i < freeRects.size(); i++) {
+            for (size_t j = i + 1; j < freeRects.size(); j++) {
+                if (contains(freeRects[j], freeRects[i])) {
+                    freeRects.erase(freeRects.begin() + i);
+                    i--;
+                    break;
+                }
+                if (contains(freeRects[i], freeRects[j])) {
+                    freeRects.erase(freeRects.begin() + j);
+                    j--;
+                }
+            }
+        }
+
+        usedWidth = std::max(usedWidth, rect.x + rect.width);
+        usedHeight = std::max(usedHeight, rect.y + rect.height);
+    }
+
+    std::vector<AtlasRect> freeRects;
+    uint32_t usedWidth = 0, usedHeight = 0;
+};
+
+struct AtlasSprite {
+    std::string name;
+    std::vector<uint8_t> pixels;        //  trimmed, top down RGBA
+    uint32_t width, height;
+    uint32_t trimX, trimY;
+    uint32_t sourceWidth, sourceHeight;
+    uint32_t page, x, y;
+};
+
+uint32_t nextPowerOfTwo(uint32_t value) {
+    uint32_t power = 1;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+//  packs every TGA in an .atlas directory into as few pages as will hold them, and adds the pages
+//  (as built textures) and their table (see atlasFormat.h) to the archive in place of the source images
+bool compileAtlas(std::string const& atlasName, std::vector<std::string> filenames) {
+    std::sort(filenames.begin(), filenames.end());
+
+    std::vector<AtlasSprite> sprites(filenames.size());
+    for (size_t i = 0; i < filenames.size(); i++) {
+        AtlasSprite& sprite = sprites[i];
+        sprite.name = filenames[i].substr(atlasName.length() + 1, filenames[i].length() - atlasName.length() - 5);
+        std::replace(sprite.name.begin(), sprite.name.end(), '\\', '/');
+
+        Asset asset(filenames[i]);
+        std::vector<uint8_t> source;
+        if (!decodeTGA(&asset, source, sprite.sourceWidth, sprite.sourceHeight)) {
+            return false;
+        }
+
+        //  trim fully transparent borders. a blank image keeps a single pixel
+        uint32_t left = sprite.sourceWidth, top = sprite.sourceHeight, right = 0, bottom = 0;
+        for (uint32_t y = 0; y < sprite.sourceHeight; y++) {
+            for (uint32_t x = 0; x < sprite.sourceWidth; x++) {
+                if (source[(y * sprite.sourceWidth + x) * 4 + 3] != 0) {
+                    left = std::min(left, x);
+                    top = std::min(top, y);
+                    right = std::max(right, x + 1);
+                    bottom = std::max(bottom, y + 1);
+                }
+            }
+        }
+        if (right == 0) {
+            left = top = 0;
+            right = bottom = 1;
+        }
+
+        sprite.trimX = left;
+        sprite.trimY = top;
+        sprite.width = right - left;
+        sprite.height = bottom - top;
+        sprite.pixels.resize(sprite.width * sprite.height * 4);
+        for (uint32_t y = 0; y < sprite.height; y++) {
+            std::memcpy(&sprite.pixels[y * sprite.width * 4], &source[((top + y) * sprite.sourceWidth + left) * 4], sprite.width * 4);
+        }
+    }
+
+    //  biggest first packs tightest
+    std::vector<size_t> order(sprites.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        uint32_t sideA = std::max(sprites[a].width, sprites[a].height);
+        uint32_t sideB = std::max(sprites[b].width, sprites[b].height);
+        return sideA != sideB ? sideA > sideB : sprites[a].width * sprites[a].height > sprites[b].width * sprites[b].height;
+    });
+
+    const uint32_t border = AB::ATLAS_EXTRUDE * 2 + AB::ATLAS_PADDING;
+    std::vector<AtlasPage> pages;
+    for (size_t i : order) {
+        AtlasSprite& sprite = sprites[i];
+        uint32_t width = sprite.width + border;
+        uint32_t height = sprite.height + border;
+        if (width > AB::ATLAS_MAX_PAGE_SIZE || height > AB::ATLAS_MAX_PAGE_SIZE) {
+            std::cerr << "Sprite " << sprite.name << " in " << atlasName << " is too big for a " << AB::ATLAS_MAX_PAGE_SIZE << " atlas page" << std::endl;
+            return false;
+        }
+
+        //  best fit over every open page, starting a new one when nothing fits
+        AtlasRect best;
+        uint32_t bestScore = 0, bestPage = 0;
+        bool found = false;
+        for (uint32_t page = 0; page < pages.size(); page++) {
+            AtlasRect rect;
+            uint32_t score;
+            if (pages[page].find(width, height, rect, score) && (!found || score < bestScore)) {
+                best = rect;
+                bestScore = score;
+                bestPage = page;
+                found = true;
+            }
+        }
+        if (!found) {
+            pages.emplace_back(AB::ATLAS_MAX_PAGE_SIZE);
+            bestPage = pages.size() - 1;
+            pages.back().find(width, height, best, bestScore);
+        }
+
+        pages[bestPage].place(best);
+        sprite.page = bestPage;
+        sprite.x = best.x + AB::ATLAS_EXTRUDE;
+        sprite.y = best.y + AB::ATLAS_EXTRUDE;
+    }
+
+    //  shrink each page to what it uses. pages stay power of two so they need no padding at load time
+    std::vector<std::vector<uint8_t>> pagePixels(pages.size());
+    std::vector<uint32_t> pageWidths(pages.size()), pageHeights(pages.size());
+    for (size_t page = 0; page < pages.size(); page++) {
+        pageWidths[page] = nextPowerOfTwo(pages[page].usedWidth);
+        pageHeights[page] = nextPowerOfTwo(pages[page].usedHeight);
+        pagePixels[page].assign(pageWidths[page] * pageHeights[page] * 4, 0);
+    }
+
+    for (const auto& sprite : sprites) {
+        uint32_t pageWidth = pageWidths[sprite.page];
+        uint8_t* pixels = pagePixels[sprite.page].data();
+
+        //  copy the sprite, then repeat its edge pixels outwards into the border
+        int32_t extrude = AB::ATLAS_EXTRUDE;
+        for (int32_t y = -extrude; y < (int32_t)sprite.height + extrude; y++) {
+            int32_t sourceY = std::clamp(y, 0, (int32_t)sprite.height - 1);
+            for (int32_t x = -extrude; x < (int32_t)sprite.width + extrude; x++) {
+                int32_t sourceX = std::clamp(x, 0, (int32_t)sprite.width - 1);
+                std::memcpy(&pixels[((sprite.y + y) * pageWidth + sprite.x + x) * 4], &sprite.pixels[(sourceY * sprite.width + sourceX) * 4], 4);
+            }
+        }
+    }
+
+    std::string names;
+    std::vector<AB::AtlasEntry> entries;
+    for (const auto& sprite : sprites) {
+        AB::AtlasEntry entry;
+        entry.nameOffset = names.size();
+        entry.page = sprite.page;
+        entry.x = sprite.x;
+        entry.y = sprite.y;
+        entry.width = sprite.width;
+        entry.height = sprite.height;
+        entry.trimX = sprite.trimX;
+        entry.trimY = sprite.trimY;
+        entry.sourceWidth = sprite.sourceWidth;
+        entry.sourceHeight = sprite.sourceHeight;
+        entry.reserved = 0;
+        entries.push_back(entry);
+
+        names += sprite.name;
+        names += '\0';
+    }
+    names.resize((names.size() + 3) & ~3, '\0');
+
+    AB::AtlasHeader header;
+    std::memcpy(header.magic, AB::ATLAS_MAGIC, sizeof(AB::ATLAS_MAGIC));
+    header.version = AB::ATLAS_VERSION;
+    header.pageCount = pages.size();
+    header.entryCount = entries.size();
+    header.namesSize = names.size();
+
+    uint64_t size = sizeof(header) + entries.size() * sizeof(AB::AtlasEntry) + names.size();
+    uint8_t* data = new uint8_t[size];
+    uint8_t* p = data;
+    std::memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    if (!entries.empty()) {
+        std::memcpy(p, entries.data(), entries.size() * sizeof(AB::AtlasEntry));
+        p += entries.size() * sizeof(AB::AtlasEntry);
+    }
+    std::memcpy(p, names.data(), names.size());
+    assets.push_back(new Asset(atlasName, data, size));
+
+    for (size_t page = 0; page < pages.size(); page++) {
+        std::vector<uint8_t> texture = buildTexture(pagePixels[page], pageWidths[page], pageHeights[page]);
+        uint8_t* pageData = new uint8_t[texture.size()];
+        std::memcpy(pageData, texture.data(), texture.size());
+        assets.push_back(new Asset(atlasName + "." + std::to_string(page) + ".tga", pageData, texture.size()));
+
+        std::cout << "Packed " << atlasName << " page " << page << ": " << pageWidths[page] << "x" << pageHeights[page] << std::endl;
+    }
+    std::cout << "Compiled atlas " << atlasName << ": " << sprites.size() << " sprites on " << pages.size() << " pages" << std::endl;
+
+    return true;
+}
+
+//  the .atlas directory a file sits in, if any
+std::string atlasDirectory(std::string const& filename) {
+    std::filesystem::path directory = std::filesystem::path(filename).parent_path();
+    while (!directory.empty()) {
+        if (endsWith(directory.filename().string(), ".atlas")) {
+            return directory.string();
+        }
+        directory = directory.parent_path();
+    }
+    return "";
+}
+
 void zerr(int32_t ret) {
     switch (ret) {
         case Z_ERRNO: std::cerr << "I/O error" << std::endl; exit(ret); break;
@@ -243,6 +822,9 @@ void report(uint64_t sizeDataOriginal, uint32_t outputSize) {
 }
 
 void buildArchive(std::string archivePath) {
+    //  images in .atlas directories are packed rather than added as they are
+    std::map<std::string, std::vector<std::string>> atlases;
+
     //  read all asset files
     for (const auto& entry : std::filesystem::recursive_directory_iterator(".")) {
         if (!std::filesystem::is_directory(entry.status())) {
@@ -273,11 +855,31 @@ void buildArchive(std::string archivePath) {
                         filename = output;
                     }
 #endif
-                    assets.push_back(new Asset(filename));
+                    std::string atlas = atlasDirectory(filename);
+                    if (!atlas.empty() && endsWith(filename, ".tga")) {
+                        atlases[atlas].push_back(filename);
+                        continue;
+                    }
+
+                    Asset* asset = new Asset(filename);
+                    if (endsWith(filename, ".fnt") && !compileFont(asset)) {
+                        lua_close(luaVM);
+                        exit(1);
+                    }
+                    if (textureBlobs && endsWith(filename, ".tga")) {
+                        compileTexture(asset);
+                    }
+                    assets.push_back(asset);
                 }
             }
         }
     }
+    for (const auto& [atlas, filenames] : atlases) {
+        if (!compileAtlas(atlas, filenames)) {
+            lua_close(luaVM);
+            exit(1);
+        }
+    }
     std::cout << std::endl;
 
     //  build manifest
@@ -341,13 +943,25 @@ void buildArchive(std::string archivePath) {
 }
 
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
+    //  --mipmaps and --texture-blobs may go anywhere, the rest are positional
+    std::vector<std::string> arguments;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--mipmaps") {
+            mipmaps = true;
+        } else if (std::string(argv[i]) == "--texture-blobs") {
+            textureBlobs = true;
+        } else {
+            arguments.push_back(argv[i]);
+        }
+    }
+
+    if (arguments.empty()) {
         std::cout << "Mustard Engine Asset Compiler\n\n";
-        std::cout << "Usage: Mustard-AssetCompiler outputFile.dat [key]\n";
+        std::cout << "Usage: Mustard-AssetCompiler outputFile.dat [key] [--mipmaps] [--texture-blobs]\n";
     } else {
-        std::cout << "Building archive [" << argv[1] << "]...\n\n";
+        std::cout << "Building archive [" << arguments[0] << "]...\n\n";
 
-        key = argc > 2 ? argv[2] : NULL;
+        key = arguments.size() > 1 ? arguments[1] : "";
         std::cout << "KEY: " << key << "\n\n";
 
         luaVM = luaL_newstate();
@@ -355,7 +969,7 @@ int main(int argc, char* argv[]) {
            std::cerr << "Error initializing Lua VM";
         }
         luaL_openlibs(luaVM);
-        buildArchive(argv[1]);
+        buildArchive(arguments[0]);
         lua_close(luaVM);
     }
 
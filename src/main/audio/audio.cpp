@@ -274,6 +274,28 @@ void Audio::pauseAll() {
     }
 }
 
+u32 Audio::countPlayingVoices() {
+    u32 count = 0;
+
+    extern AssetManager<Music> music;
+    for (const auto& pair : music.assetData) {
+        if (pair.second->isPlaying()) {
+            count++;
+        }
+    }
+
+    extern AssetManager<Sound> sounds;
+    for (const auto& pair : sounds.assetData) {
+        for (u32 i = 0; i < Sound::INSTANCES; i++) {
+            if (ma_sound_is_playing(&pair.second->sounds[i])) {
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
 void Audio::resumeAll() {
     for (ma_sound* sound : pausedSounds) {
         ma_sound_start(sound);
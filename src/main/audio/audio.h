@@ -91,6 +91,9 @@ class Audio : public SubSystem {
         void pauseAll();
         void resumeAll();
 
+        //    number of sound and music voices currently playing
+        u32 countPlayingVoices();
+
         f32 soundVolume = 1.0f;
         f32 musicVolume = 1.0f;
 
@@ -27,6 +27,7 @@ freely, subject to the following restrictions:
 #include "window.h"
 #include "../script/script.h"
 #include "../renderer/camera.h"
+#include "../renderer/renderThread.h"
 #include "log.h"
 
 namespace AB {
@@ -54,6 +55,8 @@ void Window::shutdown() {
 }
 
 void Window::setVideoMode(Application *app) {
+    syncRenderThread();
+
     int xRes = 800;
     int yRes = 480;
     b8 fullscreen = false;
@@ -96,6 +99,14 @@ void Window::setVideoMode(Application *app) {
         lua_pop(luaVM, -1);
         lua_pop(luaVM, -1);
 
+        lua_getglobal(luaVM, "videoConfig");
+        lua_pushstring(luaVM, "pipelined");
+        lua_gettable(luaVM, -2);
+        pipelined = (b8)lua_toboolean(luaVM, -1);
+        LOG_EXP(pipelined);
+        lua_pop(luaVM, -1);
+        lua_pop(luaVM, -1);
+
         lua_getglobal(luaVM, "videoConfig");
         lua_pushstring(luaVM, "title");
         lua_gettable(luaVM, -2);
@@ -121,6 +132,11 @@ void Window::setVideoMode(Application *app) {
     // SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 4);
 
     Uint32 windowFlags = SDL_WINDOW_OPENGL | SDL_WINDOW_INPUT_GRABBED | SDL_WINDOW_HIDDEN | SDL_WINDOW_INPUT_FOCUS | SDL_WINDOW_SHOWN;
+    if (headless) {
+        windowFlags &= ~(SDL_WINDOW_SHOWN | SDL_WINDOW_INPUT_GRABBED | SDL_WINDOW_INPUT_FOCUS);
+        fullscreen = false;
+        vsync = false;
+    }
     
     //  commenting this out because for now because it prevents the
     //  webgl context from being created
@@ -204,7 +220,9 @@ void Window::setVideoMode(Application *app) {
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     SDL_GL_SwapWindow(window);
-    SDL_ShowWindow(window);
+    if (!headless) {
+        SDL_ShowWindow(window);
+    }
     
     LOG("\tVendor: %s", glGetString(GL_VENDOR));
     LOG("\tRenderer: %s", glGetString(GL_RENDERER));
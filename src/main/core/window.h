@@ -64,6 +64,12 @@ class Window : public SubSystem {
         SDL_Window *window;
         SDL_GLContext glContext;
 
+        //  keep the window hidden and vsync off (input replay runs)
+        b8 headless = false;
+
+        //  draw on a render thread while the next frame is updated (videoConfig.pipelined)
+        b8 pipelined = false;
+
 };
 
 }    //  namespace
@@ -51,6 +51,10 @@ static const Uint8 *keyStates;
 static Uint8 *prevKeyStates;
 static i32 numKeys;
 
+//  key and mouse button state rebuilt from replayed events
+static Uint8 *replayKeyStates = nullptr;
+static Uint32 replayMouseButtons = 0;
+
 struct Mouse {
     i32 x, y;
     b8 buttons[3];
@@ -425,14 +429,47 @@ void Input::update() {
     //  update mouse
     memcpy(mouse.prevButtons, mouse.buttons, 3);
 
-    Uint32 buttons = SDL_GetMouseState(NULL, NULL);
+    Uint32 buttons = replayKeyStates ? replayMouseButtons : SDL_GetMouseState(NULL, NULL);
     mouse.buttons[0] = buttons & SDL_BUTTON_LMASK;
     mouse.buttons[1] = buttons & SDL_BUTTON_MMASK;
     mouse.buttons[2] = buttons & SDL_BUTTON_RMASK;
 }
 
+void Input::beginReplay() {
+    replayKeyStates = new Uint8[numKeys];
+    memset(replayKeyStates, 0, numKeys);
+    replayMouseButtons = 0;
+
+    keyStates = replayKeyStates;
+}
+
+void Input::replayEvent(SDL_Event const& event) {
+    if (!replayKeyStates) {
+        return;
+    }
+
+    switch (event.type) {
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+            if (event.key.keysym.scancode < numKeys) {
+                replayKeyStates[event.key.keysym.scancode] = event.type == SDL_KEYDOWN ? 1 : 0;
+            }
+            break;
+
+        case SDL_MOUSEBUTTONDOWN:
+            replayMouseButtons |= SDL_BUTTON(event.button.button);
+            break;
+
+        case SDL_MOUSEBUTTONUP:
+            replayMouseButtons &= ~SDL_BUTTON(event.button.button);
+            break;
+    }
+}
+
 void Input::shutdown() {
     delete [] prevKeyStates;
+    delete [] replayKeyStates;
+    replayKeyStates = nullptr;
 
     for (u32 i = 0; i < numGamepads; i++) {
         SDL_GameControllerClose(connectedGamepads[i].gamepad);
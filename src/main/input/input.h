@@ -109,6 +109,10 @@ std::unordered_map<int, std::string> keyNames = {
         void shutdown() override;
         void update(); //  has to be called before events are pumped or after update is called
 
+        //  replayed events don't go through SDL, so key and mouse button state is rebuilt from them
+        void beginReplay();
+        void replayEvent(SDL_Event const& event);
+
         //    keyboard functions
         b8 wasKeyPressed(u32 key);
         b8 isKeyPressed(u32 key);    // 6y77  -Rilo Kitty, 4/19/20
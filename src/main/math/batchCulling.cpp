@@ -0,0 +1,251 @@
+/**
+
+zlib License
+
+(C) 2023 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#include <algorithm>
+
+#include "batchCulling.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define AB_CULL_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AB_CULL_SSE2
+#endif
+
+namespace AB {
+
+//  a box is outside a plane if its corner furthest along the normal is behind it. which corner
+//  that is only depends on the plane, so pick the arrays once per plane rather than per box
+struct BoxPlane {
+    f32 nx, ny, nz, d;
+    const f32 *x, *y, *z;
+};
+
+static void setupBoxPlanes(const Frustum& frustum, const f32* minX, const f32* minY, const f32* minZ,
+    const f32* maxX, const f32* maxY, const f32* maxZ, BoxPlane planes[6]) {
+
+    for (u32 p = 0; p < 6; p++) {
+        const Plane& plane = frustum.plane[p];
+        planes[p].nx = plane.normal.x;
+        planes[p].ny = plane.normal.y;
+        planes[p].nz = plane.normal.z;
+        planes[p].d = plane.d;
+        planes[p].x = plane.normal.x >= 0 ? maxX : minX;
+        planes[p].y = plane.normal.y >= 0 ? maxY : minY;
+        planes[p].z = plane.normal.z >= 0 ? maxZ : minZ;
+    }
+}
+
+//  same arithmetic order as Plane::getSignedDistanceToPoint so every path agrees
+static inline b8 boxInside(const BoxPlane planes[6], u32 i) {
+    for (u32 p = 0; p < 6; p++) {
+        const BoxPlane& plane = planes[p];
+        f32 distance = plane.nx * plane.x[i] + plane.ny * plane.y[i] + plane.nz * plane.z[i] - plane.d;
+        if (distance < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static inline b8 sphereInside(const Frustum& frustum, f32 x, f32 y, f32 z, f32 radius) {
+    for (u32 p = 0; p < 6; p++) {
+        const Plane& plane = frustum.plane[p];
+        f32 distance = plane.normal.x * x + plane.normal.y * y + plane.normal.z * z - plane.d;
+        if (distance < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void cullBoxesScalar(const Frustum& frustum, const f32* minX, const f32* minY, const f32* minZ,
+    const f32* maxX, const f32* maxY, const f32* maxZ, u32 count, u32* visibility) {
+
+    BoxPlane planes[6];
+    setupBoxPlanes(frustum, minX, minY, minZ, maxX, maxY, maxZ, planes);
+
+    std::fill(visibility, visibility + visibilityWords(count), 0);
+    for (u32 i = 0; i < count; i++) {
+        if (boxInside(planes, i)) {
+            visibility[i >> 5] |= 1u << (i & 31);
+        }
+    }
+}
+
+void cullSpheresScalar(const Frustum& frustum, const f32* x, const f32* y, const f32* z, const f32* radius,
+    u32 count, u32* visibility) {
+
+    std::fill(visibility, visibility + visibilityWords(count), 0);
+    for (u32 i = 0; i < count; i++) {
+        if (sphereInside(frustum, x[i], y[i], z[i], radius[i])) {
+            visibility[i >> 5] |= 1u << (i & 31);
+        }
+    }
+}
+
+#if defined(AB_CULL_AVX2)
+
+void cullBoxes(const Frustum& frustum, const f32* minX, const f32* minY, const f32* minZ,
+    const f32* maxX, const f32* maxY, const f32* maxZ, u32 count, u32* visibility) {
+
+    BoxPlane planes[6];
+    setupBoxPlanes(frustum, minX, minY, minZ, maxX, maxY, maxZ, planes);
+
+    std::fill(visibility, visibility + visibilityWords(count), 0);
+
+    const __m256 zero = _mm256_setzero_ps();
+    u32 i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (u32 p = 0; p < 6; p++) {
+            const BoxPlane& plane = planes[p];
+            __m256 distance = _mm256_add_ps(
+                _mm256_mul_ps(_mm256_set1_ps(plane.nx), _mm256_loadu_ps(plane.x + i)),
+                _mm256_mul_ps(_mm256_set1_ps(plane.ny), _mm256_loadu_ps(plane.y + i)));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.nz), _mm256_loadu_ps(plane.z + i)));
+            distance = _mm256_sub_ps(distance, _mm256_set1_ps(plane.d));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, zero, _CMP_GE_OQ));
+        }
+        visibility[i >> 5] |= (u32)_mm256_movemask_ps(inside) << (i & 31);
+    }
+    for (; i < count; i++) {
+        if (boxInside(planes, i)) {
+            visibility[i >> 5] |= 1u << (i & 31);
+        }
+    }
+}
+
+void cullSpheres(const Frustum& frustum, const f32* x, const f32* y, const f32* z, const f32* radius,
+    u32 count, u32* visibility) {
+
+    std::fill(visibility, visibility + visibilityWords(count), 0);
+
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    u32 i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 px = _mm256_loadu_ps(x + i);
+        __m256 py = _mm256_loadu_ps(y + i);
+        __m256 pz = _mm256_loadu_ps(z + i);
+        __m256 negativeRadius = _mm256_xor_ps(_mm256_loadu_ps(radius + i), signMask);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (u32 p = 0; p < 6; p++) {
+            const Plane& plane = frustum.plane[p];
+            __m256 distance = _mm256_add_ps(
+                _mm256_mul_ps(_mm256_set1_ps(plane.normal.x), px),
+                _mm256_mul_ps(_mm256_set1_ps(plane.normal.y), py));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.normal.z), pz));
+            distance = _mm256_sub_ps(distance, _mm256_set1_ps(plane.d));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+        }
+        visibility[i >> 5] |= (u32)_mm256_movemask_ps(inside) << (i & 31);
+    }
+    for (; i < count; i++) {
+        if (sphereInside(frustum, x[i], y[i], z[i], radius[i])) {
+            visibility[i >> 5] |= 1u << (i & 31);
+        }
+    }
+}
+
+#elif defined(AB_CULL_SSE2)
+
+void cullBoxes(const Frustum& frustum, const f32* minX, const f32* minY, const f32* minZ,
+    const f32* maxX, const f32* maxY, const f32* maxZ, u32 count, u32* visibility) {
+
+    BoxPlane planes[6];
+    setupBoxPlanes(frustum, minX, minY, minZ, maxX, maxY, maxZ, planes);
+
+    std::fill(visibility, visibility + visibilityWords(count), 0);
+
+    const __m128 zero = _mm_setzero_ps();
+    u32 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (u32 p = 0; p < 6; p++) {
+            const BoxPlane& plane = planes[p];
+            __m128 distance = _mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(plane.nx), _mm_loadu_ps(plane.x + i)),
+                _mm_mul_ps(_mm_set1_ps(plane.ny), _mm_loadu_ps(plane.y + i)));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.nz), _mm_loadu_ps(plane.z + i)));
+            distance = _mm_sub_ps(distance, _mm_set1_ps(plane.d));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, zero));
+        }
+        visibility[i >> 5] |= (u32)_mm_movemask_ps(inside) << (i & 31);
+    }
+    for (; i < count; i++) {
+        if (boxInside(planes, i)) {
+            visibility[i >> 5] |= 1u << (i & 31);
+        }
+    }
+}
+
+void cullSpheres(const Frustum& frustum, const f32* x, const f32* y, const f32* z, const f32* radius,
+    u32 count, u32* visibility) {
+
+    std::fill(visibility, visibility + visibilityWords(count), 0);
+
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    u32 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 pz = _mm_loadu_ps(z + i);
+        __m128 negativeRadius = _mm_xor_ps(_mm_loadu_ps(radius + i), signMask);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (u32 p = 0; p < 6; p++) {
+            const Plane& plane = frustum.plane[p];
+            __m128 distance = _mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(plane.normal.x), px),
+                _mm_mul_ps(_mm_set1_ps(plane.normal.y), py));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.normal.z), pz));
+            distance = _mm_sub_ps(distance, _mm_set1_ps(plane.d));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+        }
+        visibility[i >> 5] |= (u32)_mm_movemask_ps(inside) << (i & 31);
+    }
+    for (; i < count; i++) {
+        if (sphereInside(frustum, x[i], y[i], z[i], radius[i])) {
+            visibility[i >> 5] |= 1u << (i & 31);
+        }
+    }
+}
+
+#else
+
+void cullBoxes(const Frustum& frustum, const f32* minX, const f32* minY, const f32* minZ,
+    const f32* maxX, const f32* maxY, const f32* maxZ, u32 count, u32* visibility) {
+    cullBoxesScalar(frustum, minX, minY, minZ, maxX, maxY, maxZ, count, visibility);
+}
+
+void cullSpheres(const Frustum& frustum, const f32* x, const f32* y, const f32* z, const f32* radius,
+    u32 count, u32* visibility) {
+    cullSpheresScalar(frustum, x, y, z, radius, count, visibility);
+}
+
+#endif
+
+}   //  namespace
@@ -0,0 +1,106 @@
+/**
+
+zlib License
+
+(C) 2023 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#ifndef AB_BATCH_CULLING_H
+#define AB_BATCH_CULLING_H
+
+#include <vector>
+
+#include "frustum.h"
+
+namespace AB {
+
+//  Frustum tests for lots of bounds at once. Bounds are kept as structure of arrays so four
+//  (SSE2) or eight (AVX2) objects go through each plane per instruction, and the result is a
+//  bitmask: bit (i % 32) of word (i / 32) is set if object i is at least partly inside. Same
+//  answers as Frustum::boxInFrustum / sphereInFrustum.
+//
+//  The Scalar versions are always there, for platforms without SSE2 and for comparison.
+
+struct AABBArray {
+    std::vector<f32> minX, minY, minZ;
+    std::vector<f32> maxX, maxY, maxZ;
+
+    void add(const AABB& box) {
+        minX.push_back(box.min.x);
+        minY.push_back(box.min.y);
+        minZ.push_back(box.min.z);
+        maxX.push_back(box.max.x);
+        maxY.push_back(box.max.y);
+        maxZ.push_back(box.max.z);
+    }
+    void clear() {
+        minX.clear(); minY.clear(); minZ.clear();
+        maxX.clear(); maxY.clear(); maxZ.clear();
+    }
+    u32 size() const { return minX.size(); }
+};
+
+struct SphereArray {
+    std::vector<f32> x, y, z, radius;
+
+    void add(const Vec3& center, f32 r) {
+        x.push_back(center.x);
+        y.push_back(center.y);
+        z.push_back(center.z);
+        radius.push_back(r);
+    }
+    void clear() {
+        x.clear(); y.clear(); z.clear(); radius.clear();
+    }
+    u32 size() const { return x.size(); }
+};
+
+inline u32 visibilityWords(u32 count) { return (count + 31) / 32; }
+
+inline b8 isVisible(const u32* visibility, u32 index) {
+    return (visibility[index >> 5] >> (index & 31)) & 1;
+}
+
+//  visibility needs visibilityWords(count) words
+void cullBoxes(const Frustum& frustum, const f32* minX, const f32* minY, const f32* minZ,
+    const f32* maxX, const f32* maxY, const f32* maxZ, u32 count, u32* visibility);
+void cullBoxesScalar(const Frustum& frustum, const f32* minX, const f32* minY, const f32* minZ,
+    const f32* maxX, const f32* maxY, const f32* maxZ, u32 count, u32* visibility);
+
+void cullSpheres(const Frustum& frustum, const f32* x, const f32* y, const f32* z, const f32* radius,
+    u32 count, u32* visibility);
+void cullSpheresScalar(const Frustum& frustum, const f32* x, const f32* y, const f32* z, const f32* radius,
+    u32 count, u32* visibility);
+
+inline void cullBoxes(const Frustum& frustum, const AABBArray& boxes, std::vector<u32>& visibility) {
+    visibility.resize(visibilityWords(boxes.size()));
+    cullBoxes(frustum, boxes.minX.data(), boxes.minY.data(), boxes.minZ.data(),
+        boxes.maxX.data(), boxes.maxY.data(), boxes.maxZ.data(), boxes.size(), visibility.data());
+}
+
+inline void cullSpheres(const Frustum& frustum, const SphereArray& spheres, std::vector<u32>& visibility) {
+    visibility.resize(visibilityWords(spheres.size()));
+    cullSpheres(frustum, spheres.x.data(), spheres.y.data(), spheres.z.data(), spheres.radius.data(),
+        spheres.size(), visibility.data());
+}
+
+}   //  namespace
+
+#endif
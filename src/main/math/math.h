@@ -33,6 +33,7 @@ freely, subject to the following restrictions:
 #include "random.h"
 #include "perlin.h"
 #include "frustum.h"
+#include "batchCulling.h"
 
 namespace AB {
     
@@ -33,9 +33,25 @@ freely, subject to the following restrictions:
 namespace AB {
 
 PRNG globalPRNG;
+static b8 seedPinned = false;
 
 void rndSeed(u32 seed) { globalPRNG.reseed(seed); }
 
+void rndSeedFromClock() {
+    if (seedPinned) {
+        globalPRNG.reseed(rnd(0xFFFFFFFFU));
+    } else {
+        globalPRNG.reseed(time(NULL));
+    }
+}
+
+void rndPinSeed(u32 seed) {
+    globalPRNG.reseed(seed);
+    seedPinned = true;
+}
+
+u64 rndState() { return globalPRNG.getState(); }
+
 f64 rnd() { return globalPRNG.rnd(); }
 u32 rnd(u32 n) { return globalPRNG.rnd(n); }
 i32 rnd(i32 lb, i32 ub) { return globalPRNG.rnd(lb, ub); }
@@ -35,6 +35,7 @@ class PRNG {
         PRNG(u32 seed);
 
         void reseed(u32 seed);
+        u64 getState() const { return ((u64)state.x << 32) | state.y; }
 
         f64 rnd();
         u32 rnd(u32 n);
@@ -54,6 +55,12 @@ class PRNG {
 
 void rndSeed(u32 seed);
 
+//  reseeds from the wall clock unless the seed has been pinned for input record/replay,
+//  in which case the new seed is drawn from the global PRNG so the sequence stays reproducible
+void rndSeedFromClock();
+void rndPinSeed(u32 seed);
+u64 rndState();
+
 //  TODO: document ranges (inclusive, etc)
 f64 rnd();
 u32 rnd(u32 n);
@@ -0,0 +1,127 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#ifndef AB_PACKING_H
+#define AB_PACKING_H
+
+#include <cmath>
+#include <cstring>
+
+#include "../types.h"
+
+namespace AB {
+
+//  IEEE half float, rounded to nearest even. too-large values become infinity
+inline u16 floatToHalf(f32 f) {
+    u32 bits;
+    memcpy(&bits, &f, sizeof(u32));
+
+    u32 sign = (bits >> 16) & 0x8000;
+    u32 absBits = bits & 0x7FFFFFFF;
+
+    //  infinity and NaN
+    if (absBits >= 0x7F800000) {
+        return sign | 0x7C00 | (absBits > 0x7F800000 ? 0x200 : 0);
+    }
+
+    //  rounds past 65504
+    if (absBits >= 0x477FF000) {
+        return sign | 0x7C00;
+    }
+
+    //  too small for a normal half, shift the mantissa down into a subnormal
+    if (absBits < 0x38800000) {
+        if (absBits < 0x33000000) {
+            return sign;
+        }
+
+        u32 shift = 126 - (absBits >> 23);
+        u32 mantissa = (absBits & 0x7FFFFF) | 0x800000;
+        u32 half = mantissa >> shift;
+        u32 rest = mantissa & ((1u << shift) - 1);
+        u32 halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1))) {
+            half++;
+        }
+        return sign | half;
+    }
+
+    //  rebias the exponent from 127 to 15. a carry out of the mantissa bumps the exponent, which is
+    //  what rounding up should do
+    u32 half = (absBits - 0x38000000) >> 13;
+    u32 rest = absBits & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) {
+        half++;
+    }
+    return sign | half;
+}
+
+inline f32 halfToFloat(u16 h) {
+    u32 sign = (u32)(h & 0x8000) << 16;
+    u32 exponent = (h >> 10) & 0x1F;
+    u32 mantissa = h & 0x3FF;
+
+    u32 bits;
+    if (exponent == 0x1F) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else {
+        //  subnormal half, normalize it
+        exponent = 113;
+        while (!(mantissa & 0x400)) {
+            mantissa <<= 1;
+            exponent--;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+    }
+
+    f32 f;
+    memcpy(&f, &bits, sizeof(f32));
+    return f;
+}
+
+//  [0, 1] to the full range of an unsigned integer, clamping anything outside
+inline u16 packUnorm16(f32 f) {
+    f = f < 0.0f ? 0.0f : (f > 1.0f ? 1.0f : f);
+    return (u16)(f * 65535.0f + 0.5f);
+}
+
+inline u8 packUnorm8(f32 f) {
+    f = f < 0.0f ? 0.0f : (f > 1.0f ? 1.0f : f);
+    return (u8)(f * 255.0f + 0.5f);
+}
+
+//  radians to 1/65536ths of a turn. wraps, so negative and large angles are fine
+inline u16 packAngle(f32 radians) {
+    f32 turns = radians / (f32)(M_PI * 2.0);
+    turns -= floorf(turns);
+    return (u16)((u32)(turns * 65536.0f + 0.5f) & 0xFFFF);
+}
+
+}   //  namespace
+
+#endif
@@ -0,0 +1,128 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#ifndef AB_RADIX_SORT_H
+#define AB_RADIX_SORT_H
+
+#include <vector>
+#include <cstring>
+#include <utility>
+
+#include "../types.h"
+
+namespace AB {
+
+struct SortKey {
+    u64 key;
+    u32 index;
+};
+
+//  maps a float onto an unsigned integer with the same ordering. -0 and +0 compare equal as
+//  floats so they're folded together here too
+inline u32 floatToSortable(f32 f) {
+    if (f == 0.0f) {
+        f = 0.0f;
+    }
+
+    u32 bits;
+    memcpy(&bits, &f, sizeof(u32));
+
+    return (bits & 0x80000000U) ? ~bits : (bits | 0x80000000U);
+}
+
+//  stable LSD radix sort on 8 bit digits. passes where every key has the same digit are
+//  skipped, so keys that only use their low bits finish in one or two passes.
+//  scratch is just working space, keeping it around between calls saves an allocation
+inline void radixSort(std::vector<SortKey>& keys, std::vector<SortKey>& scratch) {
+    const size_t count = keys.size();
+    if (count < 2) {
+        return;
+    }
+    scratch.resize(count);
+
+    u32 histograms[8][256];
+    memset(histograms, 0, sizeof(histograms));
+
+    for (size_t i = 0; i < count; i++) {
+        u64 key = keys[i].key;
+        for (u32 pass = 0; pass < 8; pass++) {
+            histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    SortKey *src = keys.data();
+    SortKey *dst = scratch.data();
+    const u64 firstKey = keys[0].key;
+
+    for (u32 pass = 0; pass < 8; pass++) {
+        u32 shift = pass * 8;
+        u32 *offsets = histograms[pass];
+
+        if (offsets[(firstKey >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        u32 total = 0;
+        for (u32 digit = 0; digit < 256; digit++) {
+            u32 n = offsets[digit];
+            offsets[digit] = total;
+            total += n;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+
+        std::swap(src, dst);
+    }
+
+    if (src != keys.data()) {
+        keys.swap(scratch);
+    }
+}
+
+//  insertion sort, for keys that are mostly in order already (last frame's depth order, say).
+//  stable. gives up and returns false once it has shifted more than maxShifts keys, leaving
+//  them in some order for radixSort to finish
+inline b8 insertionSort(SortKey* keys, size_t count, size_t maxShifts) {
+    size_t shifts = 0;
+    for (size_t i = 1; i < count; i++) {
+        SortKey key = keys[i];
+        size_t j = i;
+        while (j > 0 && keys[j - 1].key > key.key) {
+            keys[j] = keys[j - 1];
+            j--;
+            if (++shifts > maxShifts) {
+                keys[j] = key;
+                return false;
+            }
+        }
+        keys[j] = key;
+    }
+    return true;
+}
+
+}   //  namespace
+
+#endif // AB_RADIX_SORT_H
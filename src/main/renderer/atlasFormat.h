@@ -0,0 +1,73 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#ifndef AB_ATLAS_FORMAT_H
+#define AB_ATLAS_FORMAT_H
+
+#include "../types.h"
+
+namespace AB {
+
+//  Sprite atlas table written by the asset compiler for each directory named *.atlas. Its images
+//  are trimmed, packed into pages stored next to it as texture blobs (see textureFormat.h) named
+//  <name>.atlas.0.tga, <name>.atlas.1.tga and so on, and described here. Little endian, laid out as:
+//
+//      AtlasHeader
+//      AtlasEntry[entryCount], sorted by name
+//      names, namesSize bytes of zero terminated strings, zero padded to a multiple of 4
+//
+//  Rectangles are in pixels from the top left of the page. Each one has its edge pixels extruded
+//  outwards by ATLAS_EXTRUDE so filtering at the edges doesn't pick up the neighbours.
+
+static const char ATLAS_MAGIC[4] = { 'A', 'B', 'A', 'T' };
+static const u32 ATLAS_VERSION = 1;
+
+static const u32 ATLAS_MAX_PAGE_SIZE = 2048;
+static const u32 ATLAS_EXTRUDE = 1;
+static const u32 ATLAS_PADDING = 1;
+
+struct AtlasHeader {
+    char magic[4];
+    u32 version;
+    u32 pageCount;
+    u32 entryCount;
+    u32 namesSize;
+};
+
+struct AtlasEntry {
+    u32 nameOffset;             //  into the names block, without the file extension
+    u16 page;
+    u16 x, y;
+    u16 width, height;          //  trimmed size
+    u16 trimX, trimY;           //  where the trimmed rectangle sat in the source image
+    u16 sourceWidth, sourceHeight;
+    u16 reserved;
+};
+
+static_assert(sizeof(AtlasHeader) == 20, "AtlasHeader must be packed");
+static_assert(sizeof(AtlasEntry) == 24, "AtlasEntry must be packed");
+
+}   //  namespace
+
+#endif
@@ -0,0 +1,298 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#include "../pch.h"
+
+#include "dynamicAtlas.h"
+#include "renderThread.h"
+#include "renderLayer.h"
+#include "textureArray.h"
+#include "../core/log.h"
+
+namespace AB {
+
+DynamicAtlas::DynamicAtlas(u32 pageSize, u32 padding) : padding(padding) {
+    syncRenderThread();
+    GLint maxTextureSize;
+    CALL_GL(glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize));
+    this->pageSize = min(pageSize, (u32)maxTextureSize);
+}
+
+//  sprites hold on to their pages' textures, so they still draw after the atlas is gone
+DynamicAtlas::~DynamicAtlas() {
+}
+
+//  bottom left skyline: the rectangle goes wherever its top ends up lowest, resting on the
+//  highest segment under it. ties go to the narrowest segment, which leaves fewer slivers
+b8 DynamicAtlas::allocate(std::vector<Segment>& skyline, u32 pageSize, u32 width, u32 height, u32& x, u32& y) {
+    u32 bestIndex = skyline.size();
+    u32 bestTop = 0, bestWidth = 0;
+    for (u32 i = 0; i < skyline.size(); i++) {
+        if (skyline[i].x + width > pageSize) {
+            break;
+        }
+
+        u32 top = 0;
+        u32 remaining = width;
+        for (u32 j = i; remaining > 0; j++) {
+            top = max(top, skyline[j].y);
+            remaining -= min(remaining, skyline[j].width);
+        }
+        top += height;
+
+        if (top <= pageSize && (bestIndex == skyline.size() || top < bestTop || (top == bestTop && skyline[i].width < bestWidth))) {
+            bestIndex = i;
+            bestTop = top;
+            bestWidth = skyline[i].width;
+        }
+    }
+    if (bestIndex == skyline.size()) {
+        return false;
+    }
+
+    x = skyline[bestIndex].x;
+    y = bestTop - height;
+
+    //  the rectangle's top becomes a new segment, swallowing whatever it covers
+    skyline.insert(skyline.begin() + bestIndex, { x, bestTop, width });
+    u32 end = x + width;
+    for (u32 i = bestIndex + 1; i < skyline.size() && skyline[i].x < end;) {
+        u32 overlap = end - skyline[i].x;
+        if (overlap >= skyline[i].width) {
+            skyline.erase(skyline.begin() + i);
+        } else {
+            skyline[i].x += overlap;
+            skyline[i].width -= overlap;
+            break;
+        }
+    }
+
+    for (u32 i = 0; i + 1 < skyline.size();) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        } else {
+            i++;
+        }
+    }
+
+    return true;
+}
+
+DynamicAtlas::Page* DynamicAtlas::openPage() {
+    syncRenderThread();
+
+    std::unique_ptr<Page> page = std::make_unique<Page>();
+    page->texture = std::make_shared<Texture>(pageSize, pageSize);
+    page->pixels.assign(pageSize * pageSize * 4, 0);
+    page->skyline.push_back({ 0, 0, pageSize });
+    page->fullyDirty = false;
+    page->usedArea = 0;
+    page->freedArea = 0;
+    page->spriteCount = 0;
+
+    //  the Texture constructor left it bound
+    CALL_GL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, pageSize, pageSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, page->pixels.data()));
+    RenderLayer::textureCache.invalidate();
+
+    pages.push_back(std::move(page));
+    return pages.back().get();
+}
+
+void DynamicAtlas::adopt(Sprite *sprite, Entry const& entry) {
+    f32 size = (f32)pageSize;
+    const Rect& rect = entry.rect;
+
+    sprite->atlasX = rect.x;
+    sprite->atlasY = rect.y;
+    sprite->adopt(entry.page->texture, rect.x / size, rect.y / size, (rect.x + rect.width) / size, (rect.y + rect.height) / size);
+}
+
+b8 DynamicAtlas::place(Page *page, Sprite *sprite) {
+    const Image* image = sprite->image.get();
+    u32 x, y;
+    if (!allocate(page->skyline, pageSize, image->width + padding, image->height + padding, x, y)) {
+        return false;
+    }
+
+    for (u32 row = 0; row < image->height; row++) {
+        memcpy(&page->pixels[((y + row) * pageSize + x) * 4], &image->data[row * image->width * 4], image->width * 4);
+    }
+
+    Entry entry = { page, { x, y, image->width, image->height } };
+    page->dirty.push_back(entry.rect);
+    page->usedArea += (image->width + padding) * (image->height + padding);
+    page->spriteCount++;
+
+    entries[sprite] = entry;
+    adopt(sprite, entry);
+
+    return true;
+}
+
+b8 DynamicAtlas::add(Sprite *sprite) {
+    if (contains(sprite)) {
+        return true;
+    }
+    if (!sprite->image) {
+        LOG("Can't add a sprite with no image to an atlas", 0);
+        return false;
+    }
+    if (sprite->image->width + padding > pageSize || sprite->image->height + padding > pageSize) {
+        return false;
+    }
+
+    for (auto& page : pages) {
+        if (place(page.get(), sprite)) {
+            return true;
+        }
+    }
+
+    //  before opening another page, see if squeezing the holes out of one makes room
+    for (auto& page : pages) {
+        if (page->freedArea >= pageSize * pageSize / 4 && repack(page.get()) && place(page.get(), sprite)) {
+            return true;
+        }
+    }
+
+    return place(openPage(), sprite);
+}
+
+void DynamicAtlas::remove(Sprite *sprite) {
+    auto entry = entries.find(sprite);
+    if (entry == entries.end()) {
+        return;
+    }
+
+    Page *page = entry->second.page;
+    const Rect& rect = entry->second.rect;
+    page->freedArea += (rect.width + padding) * (rect.height + padding);
+    page->spriteCount--;
+
+    entries.erase(entry);
+    sprite->texture.reset();
+    Sprite::generation++;
+
+    if (page->spriteCount == 0) {
+        pages.erase(std::find_if(pages.begin(), pages.end(), [page](const std::unique_ptr<Page>& p) {
+            return p.get() == page;
+        }));
+    }
+}
+
+//  packs a page's sprites again from scratch, tallest first. if they somehow don't all fit the
+//  second time around the page is left as it was
+b8 DynamicAtlas::repack(Page *page) {
+    std::vector<std::pair<Sprite* const, Entry>*> live;
+    for (auto& entry : entries) {
+        if (entry.second.page == page) {
+            live.push_back(&entry);
+        }
+    }
+    std::sort(live.begin(), live.end(), [](const std::pair<Sprite* const, Entry>* a, const std::pair<Sprite* const, Entry>* b) {
+        return a->second.rect.height != b->second.rect.height ? a->second.rect.height > b->second.rect.height : a->second.rect.width > b->second.rect.width;
+    });
+
+    std::vector<Segment> skyline = { { 0, 0, pageSize } };
+    std::vector<Rect> moved(live.size());
+    u32 usedArea = 0;
+    for (u32 i = 0; i < live.size(); i++) {
+        Rect& rect = moved[i];
+        rect.width = live[i]->second.rect.width;
+        rect.height = live[i]->second.rect.height;
+        if (!allocate(skyline, pageSize, rect.width + padding, rect.height + padding, rect.x, rect.y)) {
+            return false;
+        }
+        usedArea += (rect.width + padding) * (rect.height + padding);
+    }
+
+    std::vector<u8> pixels(pageSize * pageSize * 4, 0);
+    for (u32 i = 0; i < live.size(); i++) {
+        const Rect& from = live[i]->second.rect;
+        const Rect& to = moved[i];
+        for (u32 row = 0; row < from.height; row++) {
+            memcpy(&pixels[((to.y + row) * pageSize + to.x) * 4], &page->pixels[((from.y + row) * pageSize + from.x) * 4], from.width * 4);
+        }
+    }
+
+    page->pixels.swap(pixels);
+    page->skyline.swap(skyline);
+    page->dirty.clear();
+    page->fullyDirty = true;
+    page->usedArea = usedArea;
+    page->freedArea = 0;
+
+    for (u32 i = 0; i < live.size(); i++) {
+        live[i]->second.rect = moved[i];
+        adopt(live[i]->first, live[i]->second);
+    }
+
+    return true;
+}
+
+void DynamicAtlas::compact(f32 minFreed) {
+    for (auto& page : pages) {
+        if (page->freedArea > 0 && page->freedArea >= minFreed * pageSize * pageSize) {
+            repack(page.get());
+        }
+    }
+}
+
+void DynamicAtlas::upload() {
+    syncRenderThread();
+
+    b8 bound = false;
+    for (auto& page : pages) {
+        if (!page->fullyDirty && page->dirty.empty()) {
+            continue;
+        }
+        if (!bound) {
+            CALL_GL(glActiveTexture(GL_TEXTURE0));
+            CALL_GL(glPixelStorei(GL_UNPACK_ROW_LENGTH, pageSize));
+            bound = true;
+        }
+        CALL_GL(glBindTexture(GL_TEXTURE_2D, page->texture->glHandle));
+
+        if (page->fullyDirty) {
+            CALL_GL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, pageSize, pageSize, GL_RGBA, GL_UNSIGNED_BYTE, page->pixels.data()));
+        } else {
+            for (const Rect& rect : page->dirty) {
+                CALL_GL(glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x, rect.y, rect.width, rect.height, GL_RGBA, GL_UNSIGNED_BYTE,
+                    &page->pixels[(rect.y * pageSize + rect.x) * 4]));
+            }
+        }
+        page->dirty.clear();
+        page->fullyDirty = false;
+
+        //  a copy in a texture array would still have the old pixels
+        refreshTextureArray(page->texture->glHandle, pageSize, pageSize);
+    }
+
+    if (bound) {
+        CALL_GL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+        RenderLayer::textureCache.invalidate();
+    }
+}
+
+}   //  namespace
@@ -0,0 +1,108 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#ifndef AB_DYNAMIC_ATLAS_H
+#define AB_DYNAMIC_ATLAS_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "sprite.h"
+
+namespace AB {
+
+//  Atlas for content made at runtime. Sprites can be added and removed at any time. Each page
+//  packs with a skyline allocator, keeps a copy of its pixels, and only sends the rectangles that
+//  changed when upload() is called. A new page is opened when nothing fits, after first trying to
+//  compact pages that removals have left full of holes. Compaction moves sprites, so add between
+//  frames rather than while quads using the atlas are queued.
+class DynamicAtlas {
+    public:
+        DynamicAtlas(u32 pageSize = 1024, u32 padding = 1);
+        ~DynamicAtlas();
+
+        DynamicAtlas(const DynamicAtlas&) = delete;
+        DynamicAtlas& operator=(const DynamicAtlas&) = delete;
+
+        //  copies the sprite's image into a page and adopts it. returns false if it's bigger
+        //  than a page or has no image, in which case it keeps its own texture
+        b8 add(Sprite *sprite);
+
+        //  frees the sprite's space. it goes back to its own texture next time it's drawn
+        void remove(Sprite *sprite);
+
+        b8 contains(Sprite *sprite) const { return entries.find(sprite) != entries.end(); }
+
+        //  sends every changed rectangle to the GPU
+        void upload();
+
+        //  repacks pages where removed sprites have left at least minFreed of the page unused
+        void compact(f32 minFreed = 0.25f);
+
+        u32 getPageCount() const { return pages.size(); }
+        u32 getSpriteCount() const { return entries.size(); }
+
+    private:
+        struct Rect {
+            u32 x, y, width, height;
+        };
+
+        //  a run of the skyline. kept in a vector per page, sorted by x
+        struct Segment {
+            u32 x, y, width;
+        };
+
+        struct Page {
+            std::shared_ptr<Texture> texture;
+            std::vector<u8> pixels;             //  top down RGBA, as the texture holds it
+            std::vector<Segment> skyline;
+            std::vector<Rect> dirty;
+            b8 fullyDirty;
+            u32 usedArea;
+            u32 freedArea;
+            u32 spriteCount;
+        };
+
+        struct Entry {
+            Page *page;
+            Rect rect;
+        };
+
+        Page* openPage();
+        b8 place(Page *page, Sprite *sprite);
+        b8 repack(Page *page);
+        void adopt(Sprite *sprite, Entry const& entry);
+
+        static b8 allocate(std::vector<Segment>& skyline, u32 pageSize, u32 width, u32 height, u32& x, u32& y);
+
+        u32 pageSize;
+        u32 padding;
+        std::vector<std::unique_ptr<Page>> pages;
+        std::unordered_map<Sprite*, Entry> entries;
+};
+
+}   //  namespace
+
+#endif // AB_DYNAMIC_ATLAS_H
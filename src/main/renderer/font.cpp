@@ -27,6 +27,7 @@ freely, subject to the following restrictions:
 #include <iostream>
 
 #include "font.h"
+#include "fontFormat.h"
 #include "../core/log.h"
 
 namespace AB {
@@ -56,6 +57,10 @@ Font::Character::Character(std::shared_ptr<Texture> texture, int x, int y, int w
 Font::Character::~Character() {}
 
 void Font::load(std::string const& filename) {
+    kernings.clear();
+    extendedKernings.clear();
+    layouts.clear();
+
     if (filename == "default1") {
         LOG("Creating 8x16 built-in font", 0);
         build8x8Default(true);
@@ -68,86 +73,158 @@ void Font::load(std::string const& filename) {
     } else {
         LOG("Loading font <%s>", filename.c_str());
 
+        texture.reset();
         DataObject dataObject = fileSystem.loadAsset(filename);
-        std::string input(reinterpret_cast<char*>(dataObject.getData()), dataObject.getSize()  - 1); // crop null terminator
-        
+
         //    init chars array
         for (int i = 0; i < 256; i++) {
             chars[i] = 0;
         }
         height = 0;
 
-        std::istringstream stream(input);
-        std::string line;
-        while (std::getline(stream, line)) {
-            std::istringstream lineStream(line);
-            std::string tag;
-            lineStream >> tag;
-            if (tag == "<?xml") {
-                ERR("XML font files are no longer supported!", 0);
-            }
-            
-            std::string pair, key, value;
-            std::map<std::string, std::string> pairs;
-            
-            while (lineStream >> pair) {
-                int i = pair.find('=');
-                key = pair.substr(0, i);
-                value = pair.substr(i + 1);
-
-                pairs[key] = value;
-            }
+        //    archives carry the asset compiler's binary version, loose files are BMFont text
+        if (dataObject.getSize() >= sizeof(FontHeader) && memcmp(dataObject.getData(), FONT_MAGIC, sizeof(FONT_MAGIC)) == 0) {
+            loadBinary(dataObject.getData(), dataObject.getSize(), filename);
+        } else {
+            loadText(reinterpret_cast<char*>(dataObject.getData()), dataObject.getSize(), filename);
+        }
+    }
 
-            if (tag == "common") {
-                lineHeight = stoi(pairs.at("lineHeight"));
-                base = stoi(pairs.at("base"));
-                scaleW = stoi(pairs.at("scaleW"));
-                scaleH = stoi(pairs.at("scaleH"));
-            }
-            
-            if (tag == "page") {
-                std::string textureFile = pairs.at("file");
-                textureFile = textureFile.substr(1, textureFile.size() - 2);  // strip quotes
-                textureFile = filename.substr(0, filename.find_last_of("\\/") + 1) + textureFile;
-                texture = std::make_shared<Texture>(textureFile);
-            }
+    color = Vec4(1.0f, 1.0f, 1.0f, 1.0f);
+}
 
-            if (tag == "char") {
-                int id = stoi(pairs.at("id"));
-                int x = stoi(pairs.at("x"));
-                int y = stoi(pairs.at("y"));
-                int w = stoi(pairs.at("width"));
-                int h =  stoi(pairs.at("height"));
-                int xo = stoi(pairs.at("xoffset"));
-                int yo = stoi(pairs.at("yoffset"));
-                int xa = stoi(pairs.at("xadvance"));
-
-                if (id < 0 || id > 255) {
-                    LOG("WARNING: Character index <%d> out of range!", id);
-                } else {
-                    if (chars[id] != 0) {
-                        ERR("Duplicate character ID <%d>", id);
-                    }
+void Font::loadText(const char* data, u64 size, std::string const& filename) {
+    std::string input(data, size - 1); // crop null terminator
+
+    std::istringstream stream(input);
+    std::string line;
+    while (std::getline(stream, line)) {
+        std::istringstream lineStream(line);
+        std::string tag;
+        lineStream >> tag;
+        if (tag == "<?xml") {
+            ERR("XML font files are no longer supported!", 0);
+        }
 
-                    if (h > height) {
-                        height = h;
-                    }
+        std::string pair, key, value;
+        std::map<std::string, std::string> pairs;
 
-                    chars[id] = new Character(texture, x, y, w, h, xo, yo, xa, scaleW, scaleH);
-                }
+        while (lineStream >> pair) {
+            int i = pair.find('=');
+            key = pair.substr(0, i);
+            value = pair.substr(i + 1);
+
+            pairs[key] = value;
+        }
+
+        if (tag == "common") {
+            lineHeight = stoi(pairs.at("lineHeight"));
+            base = stoi(pairs.at("base"));
+            scaleW = stoi(pairs.at("scaleW"));
+            scaleH = stoi(pairs.at("scaleH"));
+        }
+
+        if (tag == "page" && !texture) {
+            std::string textureFile = pairs.at("file");
+            textureFile = textureFile.substr(1, textureFile.size() - 2);  // strip quotes
+            loadPage(textureFile, filename);
+        }
+
+        if (tag == "char") {
+            int id = stoi(pairs.at("id"));
+            if (id < 0) {
+                LOG("WARNING: Character index <%d> out of range!", id);
+                continue;
             }
-            
-            if (tag == "kerning") {
-                int first = stoi(pairs.at("first"));
-                int second = stoi(pairs.at("second"));
-                int amount = stoi(pairs.at("amount"));
+            addCharacter(id, stoi(pairs.at("x")), stoi(pairs.at("y")), stoi(pairs.at("width")), stoi(pairs.at("height")),
+                stoi(pairs.at("xoffset")), stoi(pairs.at("yoffset")), stoi(pairs.at("xadvance")));
+        }
 
-                kernings[first][second] = amount;
+        if (tag == "kerning") {
+            int first = stoi(pairs.at("first"));
+            int second = stoi(pairs.at("second"));
+            if (first >= 0 && second >= 0) {
+                addKerning(first, second, stoi(pairs.at("amount")));
             }
         }
     }
+}
 
-    color = Vec4(1.0f, 1.0f, 1.0f, 1.0f);
+//    straight out of the archive. the asset's offset in there has no particular alignment,
+//    so the tables are copied out rather than pointed into
+void Font::loadBinary(const u8* data, u64 size, std::string const& filename) {
+    FontHeader header;
+    memcpy(&header, data, sizeof(FontHeader));
+    if (header.version != FONT_VERSION) {
+        ERR("Font <%s> is version %d, expected %d. Rebuild the archive", filename.c_str(), header.version, FONT_VERSION);
+        return;
+    }
+
+    u64 pageOffset = sizeof(FontHeader);
+    u64 glyphOffset = pageOffset + ((header.pageNameLength + 3) & ~3);
+    u64 kerningOffset = glyphOffset + (u64)header.glyphCount * sizeof(FontGlyph);
+    if (kerningOffset + (u64)header.kerningCount * sizeof(FontKerning) > size) {
+        ERR("Font <%s> is truncated", filename.c_str());
+        return;
+    }
+
+    lineHeight = header.lineHeight;
+    base = header.base;
+    scaleW = header.scaleW;
+    scaleH = header.scaleH;
+
+    loadPage(std::string(reinterpret_cast<const char*>(data + pageOffset), header.pageNameLength), filename);
+
+    std::vector<FontGlyph> glyphs(header.glyphCount);
+    if (header.glyphCount > 0) {
+        memcpy(&glyphs[0], data + glyphOffset, header.glyphCount * sizeof(FontGlyph));
+    }
+    for (auto& glyph : glyphs) {
+        addCharacter(glyph.id, glyph.x, glyph.y, glyph.width, glyph.height, glyph.xOffset, glyph.yOffset, glyph.xAdvance);
+    }
+
+    std::vector<FontKerning> pairs(header.kerningCount);
+    if (header.kerningCount > 0) {
+        memcpy(&pairs[0], data + kerningOffset, header.kerningCount * sizeof(FontKerning));
+    }
+    for (auto& pair : pairs) {
+        addKerning(pair.first, pair.second, pair.amount);
+    }
+}
+
+//    page files are relative to the descriptor
+void Font::loadPage(std::string const& pageFile, std::string const& filename) {
+    std::string textureFile = filename.substr(0, filename.find_last_of("\\/") + 1) + pageFile;
+    texture = std::make_shared<Texture>(textureFile);
+}
+
+void Font::addCharacter(u32 id, int x, int y, int width, int height, int xOffset, int yOffset, int xAdvance) {
+    if (getCharacter(id) != 0) {
+        ERR("Duplicate character ID <%d>", id);
+        return;
+    }
+
+    if (height > this->height) {
+        this->height = height;
+    }
+
+    Character *character = new Character(texture, x, y, width, height, xOffset, yOffset, xAdvance, scaleW, scaleH);
+    if (id < 256) {
+        chars[id] = character;
+    } else {
+        extendedChars[id] = character;
+    }
+}
+
+void Font::addKerning(u32 first, u32 second, int amount) {
+    if (first < 256 && second < 256) {
+        if (kernings.empty()) {
+            kernings.assign(256 * 256, 0);
+        }
+        kernings[first * 256 + second] = amount;
+    } else {
+        extendedKernings[((u64)first << 32) | second] = amount;
+    }
 }
 
 void Font::release() {
@@ -157,7 +234,14 @@ void Font::release() {
             chars[i] = 0;
         }
     }
+    for (auto& extended : extendedChars) {
+        delete extended.second;
+    }
+    extendedChars.clear();
 
+    kernings.clear();
+    extendedKernings.clear();
+    layouts.clear();
     texture.reset();
 }
 
@@ -384,71 +468,167 @@ void Font::build3x5Default() {
     this->height = 5;
 }
 
-void Font::printString(RenderLayer *renderer, GLfloat x, GLfloat y, GLfloat scale, Align alignment, std::string const& string) {
-    float tx;
-    switch (alignment) {
-        case LEFT: tx = x; break;
-        case RIGHT: tx = x - stringLength(string, scale); break;
-        case CENTER: tx = x - stringLength(string, scale) / 2; break;
-        default: tx = x; break;
+Font::Layout& Font::findLayout(const char* string, u32 length, GLfloat scale) {
+    //    FNV-1a over the text, then the scale
+    u64 hash = 14695981039346656037ULL;
+    for (u32 i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)string[i]) * 1099511628211ULL;
     }
-    
-    for (unsigned int i = 0; i < string.length(); i++) {
-        unsigned char ascii = string[i];
-        if (chars[ascii]) {
-            float cx = tx + (chars[ascii]->xOffset * scale);
-            float cy = (-base * scale) + y - (chars[ascii]->yOffset * scale);
-            cx += (chars[ascii]->width / 2.0f) * scale;
-            cy += (chars[ascii]->height / 2.0f) * scale;
-            
-            chars[ascii]->render(renderer, Vec3(cx, cy, -1.0f), 0, Vec2(scale, scale), color);
-            
-            tx += chars[ascii]->xAdvance * scale;
+    u32 scaleBits;
+    memcpy(&scaleBits, &scale, sizeof(scaleBits));
+    hash = (hash ^ scaleBits) * 1099511628211ULL;
+
+    auto iterator = layouts.find(hash);
+    if (iterator != layouts.end()) {
+        Layout& layout = iterator->second;
+        if (layout.scale == scale && layout.text.compare(0, std::string::npos, string, length) == 0) {
+            return layout;
+        }
+        //    a collision. the newer string takes over the slot
+    } else if (layouts.size() >= MAX_LAYOUTS) {
+        //    text that's different every frame (timers, scores) tends not to come back, so
+        //    rather than keep track of ages just start over
+        layouts.clear();
+    }
+
+    Layout& layout = layouts[hash];
+    layout.text.assign(string, length);
+    layout.scale = scale;
+    layout.length = measure(string, length, scale);
+    layout.built = false;
+    layout.quads.clear();
+
+    return layout;
+}
+
+//    next code point in a UTF-8 string. bytes that don't start a valid sequence are taken as they
+//    are, so code page 437 strings for the built-in fonts still come out right
+static u32 nextCodePoint(const char* string, u32 length, u32& i) {
+    u8 lead = string[i];
+    u32 extra, codePoint;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        extra = 1;
+        codePoint = lead & 0x1F;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        extra = 2;
+        codePoint = lead & 0x0F;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        extra = 3;
+        codePoint = lead & 0x07;
+    } else {
+        i++;
+        return lead;
+    }
+
+    if (i + extra >= length) {
+        i++;
+        return lead;
+    }
+    for (u32 k = 1; k <= extra; k++) {
+        u8 continuation = string[i + k];
+        if ((continuation & 0xC0) != 0x80) {
+            i++;
+            return lead;
+        }
+        codePoint = (codePoint << 6) | (continuation & 0x3F);
+    }
+    i += extra + 1;
+
+    return codePoint;
+}
+
+void Font::buildLayout(Layout& layout) {
+    const char* string = layout.text.c_str();
+    u32 length = layout.text.length();
+    GLfloat scale = layout.scale;
+
+    layout.quads.clear();
+    layout.built = true;
+
+    float tx = 0.0f;
+    u32 i = 0;
+    while (i < length) {
+        u32 id = nextCodePoint(string, length, i);
+        Character *character = getCharacter(id);
+        if (character) {
+            float cx = tx + (character->xOffset * scale);
+            float cy = (-base * scale) - (character->yOffset * scale);
+            cx += (character->width / 2.0f) * scale;
+            cy += (character->height / 2.0f) * scale;
+
+            RenderLayer::Quad quad;
+            quad.pos = Vec3(cx, cy, -1.0f);
+            quad.size = Vec2(character->width, character->height);
+            quad.scale = Vec2(scale, scale);
+            quad.rotation = 0.0f;
+            quad.uv = Vec4(character->u1, character->v1, character->u2, character->v2);
+            quad.textureID = character->texture->glHandle;
+            quad.color = color;
+            layout.quads.push_back(quad);
+
+            tx += character->xAdvance * scale;
         } else {
-            if (ascii != 13) {
-                if (unknownCharWarnings.find(ascii) == unknownCharWarnings.end()) {
-                    LOG("WARNING: UNKNOWN CHARACTER: %d IN STRING: %s", ascii, string.c_str());
-                    unknownCharWarnings.emplace(ascii, true);
+            if (id != 13) {
+                if (unknownCharWarnings.find(id) == unknownCharWarnings.end()) {
+                    LOG("WARNING: UNKNOWN CHARACTER: %d IN STRING: %s", id, string);
+                    unknownCharWarnings.emplace(id, true);
                 }
             }
         }
 
         // kerning
-        if (i < string.length() - 1) {
-            if (kernings.count(ascii) > 0) {
-                unsigned char asciiNext = string[i + 1];
-                if (kernings[ascii].count(asciiNext) > 0) {
-                    tx += kernings[ascii][asciiNext] * scale;
-                }
-            }
+        if (i < length) {
+            u32 next = i;
+            tx += getKerning(id, nextCodePoint(string, length, next)) * scale;
         }
     }
 }
 
-int Font::stringLength(std::string const& string, GLfloat scale) {
-    int length = 0;
+void Font::printString(RenderLayer *renderer, GLfloat x, GLfloat y, GLfloat scale, Align alignment, const char* string, u32 length) {
+    Layout& layout = findLayout(string, length, scale);
+    if (!layout.built) {
+        buildLayout(layout);
+    }
+
+    float tx;
+    switch (alignment) {
+        case LEFT: tx = x; break;
+        case RIGHT: tx = x - layout.length; break;
+        case CENTER: tx = x - layout.length / 2; break;
+        default: tx = x; break;
+    }
+
+    if (!layout.quads.empty()) {
+        renderer->renderQuads(&layout.quads[0], layout.quads.size(), Vec3(tx, y, 0.0f), color);
+    }
+}
+
+int Font::measure(const char* string, u32 length, GLfloat scale) {
+    int pixels = 0;
 
-    for (unsigned int i = 0; i < string.length(); i++) {
-        unsigned char ascii = string[i];
-        if (chars[ascii]) {
-            if (i < string.length() - 1) {
-                length += chars[ascii]->xAdvance;
+    u32 i = 0;
+    while (i < length) {
+        u32 id = nextCodePoint(string, length, i);
+        Character *character = getCharacter(id);
+        if (character) {
+            if (i < length) {
+                pixels += character->xAdvance;
 
                 // kerning
-                if (kernings.count(ascii) > 0) {
-                    unsigned char asciiNext = string[i + 1];
-                    if (kernings[ascii].count(asciiNext) > 0) {
-                        length += kernings[ascii][asciiNext];
-                    }
-                }
+                u32 next = i;
+                pixels += getKerning(id, nextCodePoint(string, length, next));
             } else {
-                length += chars[ascii]->width;
+                pixels += character->width;
             }
         }
     }
-    length = (int)(length * scale);
+    pixels = (int)(pixels * scale);
+
+    return pixels;
+}
 
-    return length;
+int Font::stringLength(const char* string, u32 length, GLfloat scale) {
+    return findLayout(string, length, scale).length;
 }
 
 void Font::setColor(float r, float g, float b, float a) {
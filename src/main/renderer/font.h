@@ -53,7 +53,7 @@ class Font : public Asset {
         /**
         *    Loads a font and its associated texture from file
         *
-        *    @param filename XML font descriptor file -
+        *    @param filename BMFont text descriptor, or the binary one the asset compiler makes of it -
         *        Passing "default1" creates a built-in 8x16 pixel font.
         *        Passing "default2" creates a built-in 8x8 pixel font.
         *        Passing "default3" creates a built-in 3x5 pixel font.
@@ -70,9 +70,12 @@ class Font : public Asset {
         *    @param y screen Y coordinate of string
         *    @param scale scaling factor
         *    @param align alignment of string (LEFT, RIGHT, CENTER)
-        *    @param string the string to print
+        *    @param string the string to print, UTF-8
         */
-        void printString(RenderLayer *renderer, GLfloat x, GLfloat y, GLfloat scale, Align alignment, std::string const& string);
+        void printString(RenderLayer *renderer, GLfloat x, GLfloat y, GLfloat scale, Align alignment, const char* string, u32 length);
+        void printString(RenderLayer *renderer, GLfloat x, GLfloat y, GLfloat scale, Align alignment, std::string const& string) {
+            printString(renderer, x, y, scale, alignment, string.c_str(), string.length());
+        }
 
         /**
         *    Returns pixel-width of string
@@ -82,7 +85,10 @@ class Font : public Asset {
         *
         *    @return length of string in pixels
         */
-        int stringLength(std::string const& string, GLfloat scale);
+        int stringLength(const char* string, u32 length, GLfloat scale);
+        int stringLength(std::string const& string, GLfloat scale) {
+            return stringLength(string.c_str(), string.length(), scale);
+        }
 
         void setColor(float r, float g, float b, float a);
 
@@ -101,10 +107,33 @@ class Font : public Asset {
         int height;
 
     protected:
+        //    glyphs 0 - 255 are looked up directly, anything past that (CJK and the like) by id
         Character* chars[256];
-        std::unordered_map<int, Character*> extendedChars;
-
-        std::unordered_map<int, std::unordered_map<int, int> > kernings;
+        std::unordered_map<u32, Character*> extendedChars;
+
+        Character* getCharacter(u32 id) const {
+            if (id < 256) {
+                return chars[id];
+            }
+            auto iterator = extendedChars.find(id);
+            return iterator == extendedChars.end() ? nullptr : iterator->second;
+        }
+
+        //    [first * 256 + second], empty if the font has no kerning pairs. pairs involving
+        //    extended glyphs go in extendedKernings, by (first << 32 | second)
+        std::vector<i16> kernings;
+        std::unordered_map<u64, i16> extendedKernings;
+
+        int getKerning(u32 first, u32 second) const {
+            if (first < 256 && second < 256) {
+                return kernings.empty() ? 0 : kernings[first * 256 + second];
+            }
+            if (extendedKernings.empty()) {
+                return 0;
+            }
+            auto iterator = extendedKernings.find(((u64)first << 32) | second);
+            return iterator == extendedKernings.end() ? 0 : iterator->second;
+        }
         std::shared_ptr<Texture> texture;
         
         Vec4 color;
@@ -112,9 +141,31 @@ class Font : public Asset {
         int lineHeight, base;
 
     private:
+        //    strings are laid out once per scale and reused until the cache fills up. quads are
+        //    left aligned from (0, 0), other alignments and positions are an offset when printed
+        static const u32 MAX_LAYOUTS = 1024;
+        struct Layout {
+            std::string text;
+            GLfloat scale;
+            int length;             //    what stringLength returns
+            b8 built;               //    quads aren't needed to just measure
+            std::vector<RenderLayer::Quad> quads;
+        };
+        std::unordered_map<u64, Layout> layouts;    //    by hash of text and scale
+
+        Layout& findLayout(const char* string, u32 length, GLfloat scale);
+        int measure(const char* string, u32 length, GLfloat scale);
+        void buildLayout(Layout& layout);
+
+        void loadText(const char* data, u64 size, std::string const& filename);
+        void loadBinary(const u8* data, u64 size, std::string const& filename);
+        void loadPage(std::string const& pageFile, std::string const& filename);
+        void addCharacter(u32 id, int x, int y, int width, int height, int xOffset, int yOffset, int xAdvance);
+        void addKerning(u32 first, u32 second, int amount);
+
         void build8x8Default(bool stretch);
         void build3x5Default();
-        std::unordered_map<unsigned char, bool> unknownCharWarnings;
+        std::unordered_map<u32, bool> unknownCharWarnings;
 };
 
 }   //  namespace
@@ -0,0 +1,77 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#ifndef AB_FONT_FORMAT_H
+#define AB_FONT_FORMAT_H
+
+#include "../types.h"
+
+namespace AB {
+
+//  Binary font descriptor written by the asset compiler in place of BMFont text .fnt files, so
+//  fonts load without any parsing. Little endian, laid out as:
+//
+//      FontHeader
+//      page filename, pageNameLength bytes, zero padded to a multiple of 4
+//      FontGlyph[glyphCount]
+//      FontKerning[kerningCount], sorted by first then second
+//
+//  Only the first page is kept, same as the text loader.
+
+static const char FONT_MAGIC[4] = { 'A', 'B', 'F', 'N' };
+static const u32 FONT_VERSION = 1;
+
+struct FontHeader {
+    char magic[4];
+    u32 version;
+    i32 lineHeight;
+    i32 base;
+    u32 scaleW, scaleH;
+    u32 glyphCount;
+    u32 kerningCount;
+    u32 pageNameLength;
+};
+
+struct FontGlyph {
+    u32 id;
+    u16 x, y;
+    u16 width, height;
+    i16 xOffset, yOffset;
+    i16 xAdvance;
+    u16 page;
+};
+
+struct FontKerning {
+    u32 first;
+    u32 second;
+    i32 amount;
+};
+
+static_assert(sizeof(FontHeader) == 36, "FontHeader must be packed");
+static_assert(sizeof(FontGlyph) == 20, "FontGlyph must be packed");
+static_assert(sizeof(FontKerning) == 12, "FontKerning must be packed");
+
+}   //  namespace
+
+#endif
@@ -28,12 +28,15 @@ freely, subject to the following restrictions:
 
 #include "image.h"
 #include "tga.h"
+#include "textureFormat.h"
 
 #include "../core/fileSystem.h"
 #include "../core/log.h"
 
 namespace AB {
 
+extern FileSystem fileSystem;
+
 Image::Image(u32 width, u32 height) {
     this->width = width;
     this->height = height;
@@ -43,26 +46,43 @@ Image::Image(u32 width, u32 height) {
 }
 
 Image::Image(const std::string& tgaFilename) {
-    u32 bpp;
-
-    data = loadTGA(tgaFilename, width, height, bpp);
-    imageSize = width * height * 4;
-
-    if (bpp == 24) {
-        u8* rgba = new u8[imageSize];
-        for (u32 i = 0; i < width * height; i++) {
-            rgba[i * 4 + 0] = data[i * 3 + 0];
-            rgba[i * 4 + 1] = data[i * 3 + 1];
-            rgba[i * 4 + 2] = data[i * 3 + 2];
-            rgba[i * 4 + 3] = 255;
+    source = fileSystem.loadAsset(tgaFilename);
+    const u8* asset = source.getData();
+    u64 size = source.getSize();
+
+    //  built by the asset compiler, so already premultiplied and top down. used where it sits
+    if (asset && size >= sizeof(TextureHeader) && memcmp(asset, TEXTURE_MAGIC, sizeof(TEXTURE_MAGIC)) == 0) {
+        TextureHeader header;
+        memcpy(&header, asset, sizeof(TextureHeader));
+
+        u64 expectedSize = sizeof(TextureHeader);
+        for (u32 level = 0; level < header.mipLevels; level++) {
+            expectedSize += textureLevelSize(header.width, header.height, level);
         }
-        delete[] data;
-        data = rgba;
+        if (header.version != TEXTURE_VERSION || header.mipLevels == 0 || expectedSize > size) {
+            ERR("Image <%s> is corrupt or out of date. Rebuild the archive", tgaFilename.c_str());
+            data = NULL;
+            width = height = imageSize = 0;
+            return;
+        }
+
+        width = header.width;
+        height = header.height;
+        mipLevels = header.mipLevels;
+        imageSize = width * height * 4;
+        data = source.getData() + sizeof(TextureHeader);
+        return;
     }
+
+    //  decodes straight to RGBA, 24 bit sources included
+    u32 bpp;
+    data = decodeTGA(asset, size, tgaFilename, width, height, bpp);
+    imageSize = width * height * 4;
+    source = DataObject();
 }
 
 Image::~Image() {
-    if (data) {
+    if (data && !source.getData()) {
         delete [] data;
         data = NULL;
     }
@@ -22,7 +22,7 @@ freely, subject to the following restrictions:
 
 **/
 
-//    represents a 32bit RGBA image in system memory
+//    represents a 32bit RGBA image in system memory, rows top down like GL textures
 
 #ifndef AB_IMAGE_H
 #define AB_IMAGE_H
@@ -30,6 +30,7 @@ freely, subject to the following restrictions:
 #include <string>
 
 #include "../types.h"
+#include "../core/fileSystem.h"
 
 namespace AB {
 
@@ -59,8 +60,15 @@ class Image {
         u32 width, height;
         u32 imageSize;    // in bytes
 
+        //    images built by the asset compiler can carry mipmaps, stored after the first level in data
+        u32 mipLevels = 1;
+
     protected:
         Image() {}
+
+        //    built images point data straight into their asset, which this keeps alive. it may be
+        //    the archive itself, so don't write to them
+        DataObject source;
 };
 
 }
@@ -25,10 +25,14 @@ freely, subject to the following restrictions:
 #include "../pch.h"
 
 #include "model.h"
+#include "renderState.h"
+#include "renderThread.h"
+#include "renderer.h"
 
 namespace AB {
 
 extern FileSystem fileSystem;
+extern Renderer renderer;
 
 Mat4 Model::loadTransform = Mat4();
 
@@ -215,6 +219,7 @@ void Model::indexVBO(std::vector<Vec3> &inVertices,
 }
 
 void Model::load(std::string const& filename) {
+    syncRenderThread();
     std::vector<Vec3> vertices;
     std::vector<Vec2> UVs;
     std::vector<Vec3> normals;
@@ -235,7 +240,7 @@ void Model::load(std::string const& filename) {
 
     // create VAO
     CALL_GL(glGenVertexArrays(1, &vertexArrayID));
-    CALL_GL(glBindVertexArray(vertexArrayID));
+    renderState.bindVertexArray(vertexArrayID);
 
     // Load it into a VBO
     CALL_GL(glGenBuffers(1, &vertexBuffer));
@@ -260,6 +265,7 @@ void Model::load(std::string const& filename) {
 }
 
 void Model::release() {
+    syncRenderThread();
     CALL_GL(glDeleteBuffers(1, &vertexBuffer));
     CALL_GL(glDeleteBuffers(1, &uvBuffer));
     CALL_GL(glDeleteBuffers(1, &normalBuffer));
@@ -268,7 +274,8 @@ void Model::release() {
 }
 
 void Model::render() {
-    CALL_GL(glBindVertexArray(vertexArrayID));
+    renderer.beginDirectDraw();
+    renderState.bindVertexArray(vertexArrayID);
 
     // 1rst attribute buffer : vertices
     CALL_GL(glEnableVertexAttribArray(0));
@@ -290,12 +297,13 @@ void Model::render() {
 
     // draw tris
     CALL_GL(glDrawElements(GL_TRIANGLES, indicesSize, GL_UNSIGNED_SHORT, (void*)0));
+    renderState.stats.drawCalls++;
 
     CALL_GL(glDisableVertexAttribArray(0));
     CALL_GL(glDisableVertexAttribArray(1));
     CALL_GL(glDisableVertexAttribArray(2));
 
-    CALL_GL(glBindVertexArray(0));
+    renderState.bindVertexArray(0);
 }
 
 }   //  namespace
@@ -39,6 +39,7 @@ class Model : public Asset {
         virtual void release();
         virtual ~Model() {}
 
+        //  draws right away, to the screen only (see Renderer::beginDirectDraw)
         void render();
 
 
@@ -0,0 +1,149 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#include "../pch.h"
+
+#include "particleManager.h"
+#include "../core/log.h"
+
+namespace AB {
+
+ParticleManager::ParticleManager(u32 workerCount) {
+    nextSystem = 0;
+
+#ifndef __EMSCRIPTEN__
+    if (workerCount == 0) {
+        u32 cores = std::thread::hardware_concurrency();
+        workerCount = cores > 1 ? cores - 1 : 0;
+    }
+    for (u32 i = 0; i < workerCount; i++) {
+        workers.emplace_back(&ParticleManager::workerMain, this);
+    }
+#endif
+}
+
+ParticleManager::~ParticleManager() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+ParticleSystem* ParticleManager::add(ParticleSystem *system) {
+    systems.emplace_back(system);
+    return system;
+}
+
+void ParticleManager::remove(ParticleSystem *system) {
+    for (auto iterator = systems.begin(); iterator != systems.end(); iterator++) {
+        if (iterator->get() == system) {
+            systems.erase(iterator);
+            return;
+        }
+    }
+    ERR("Particle system not managed here", 0);
+}
+
+void ParticleManager::update() {
+    run([](ParticleSystem *system) {
+        system->update();
+    });
+}
+
+void ParticleManager::render(RenderLayer *renderLayer, PerspectiveCamera const& camera) {
+    //    sprites can load on first use, which needs the main thread
+    for (auto& system : systems) {
+        system->resolveSprites();
+    }
+
+    run([&camera](ParticleSystem *system) {
+        system->buildInstances(camera);
+    });
+
+    for (auto& system : systems) {
+        const std::vector<RenderLayer::Quad>& instances = system->getInstances();
+        renderLayer->quadBatch.insert(renderLayer->quadBatch.end(), instances.begin(), instances.end());
+    }
+}
+
+//    hands systems out one at a time. they vary a lot in size, so this balances better than
+//    splitting the list up front
+void ParticleManager::run(std::function<void(ParticleSystem*)> const& job) {
+    if (workers.empty() || systems.size() < 2) {
+        for (auto& system : systems) {
+            job(system.get());
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->job = &job;
+        nextSystem = 0;
+        pending = workers.size();
+        generation++;
+    }
+    wake.notify_all();
+
+    work();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return pending == 0; });
+    this->job = nullptr;
+}
+
+void ParticleManager::work() {
+    u32 count = systems.size();
+    for (u32 i = nextSystem.fetch_add(1); i < count; i = nextSystem.fetch_add(1)) {
+        (*job)(systems[i].get());
+    }
+}
+
+void ParticleManager::workerMain() {
+    u32 seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen] { return quit || generation != seen; });
+            if (quit) {
+                return;
+            }
+            seen = generation;
+        }
+
+        work();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending--;
+        }
+        done.notify_one();
+    }
+}
+
+}   //  namespace
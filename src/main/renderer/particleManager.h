@@ -0,0 +1,81 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#ifndef AB_PARTICLE_MANAGER_H
+#define AB_PARTICLE_MANAGER_H
+
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+#include "particleSystem.h"
+
+namespace AB {
+
+//  Owns a set of particle systems and updates and builds them across a pool of worker threads.
+//  Systems are independent and each has its own random stream, so the result is the same
+//  however the work gets split up. The calling thread takes a share of the work too.
+class ParticleManager {
+    public:
+        //    0 workers uses one less than the number of cores. builds without threads (web) always
+        //    run everything on the calling thread
+        ParticleManager(u32 workerCount = 0);
+        ~ParticleManager();
+
+        //    takes ownership
+        ParticleSystem* add(ParticleSystem *system);
+        void remove(ParticleSystem *system);
+        u32 getCount() const { return systems.size(); }
+
+        //    one fixed step for every system
+        void update();
+
+        //    sorts and builds every system's instances in parallel, then queues them on the layer
+        //    in the order the systems were added
+        void render(RenderLayer *renderLayer, PerspectiveCamera const& camera);
+
+    private:
+        void run(std::function<void(ParticleSystem*)> const& job);
+        void work();
+        void workerMain();
+
+        std::vector<std::unique_ptr<ParticleSystem>> systems;
+
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable wake, done;
+        u32 generation = 0;
+        u32 pending = 0;
+        b8 quit = false;
+
+        const std::function<void(ParticleSystem*)> *job = nullptr;
+        std::atomic<u32> nextSystem;
+};
+
+}   //  namespace
+
+#endif
@@ -27,90 +27,280 @@ freely, subject to the following restrictions:
 #include "particleSystem.h"
 #include "sprite.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AB_PARTICLES_SSE2
+#endif
+
 namespace AB {
 
-ParticleSystem::ParticleSystem(u32 maxParticles) {
-    particles.resize(maxParticles);
+extern AssetManager<Sprite> sprites;
+
+ParticleSystem::ParticleSystem(u32 maxParticles, u32 seed) {
+    random.reseed(seed != 0 ? seed : rnd(0xFFFFFFFFU));
+
     this->maxParticles = maxParticles;
-    nextParticle = 0;
+    count = 0;
+    nextReplaced = 0;
     active = false;
+
+    u32 capacity = (maxParticles + 3) & ~3;
+    for (auto field : { &posX, &posY, &posZ, &velX, &velY, &velZ, &accelerationX, &accelerationY, &accelerationZ, &dampening, &angle, &rotation }) {
+        field->assign(capacity, 0.0f);
+    }
+    lifetimeRemaining.assign(capacity, 0);
+    rank.assign(capacity, NEW_PARTICLE);
+    styles.resize(capacity);
 }
 
-void ParticleSystem::emit(ParticleParameters const& parameters) {
-    Particle& particle = particles[nextParticle];
+void ParticleSystem::emit(ParticleParameters const& parameters, u32 amount) {
+    if (maxParticles == 0) {
+        return;
+    }
+
+    Style style;
+    style.startColor = parameters.startColor;
+    style.deltaColor = Vec4(parameters.endColor.x - parameters.startColor.x, parameters.endColor.y - parameters.startColor.y,
+        parameters.endColor.z - parameters.startColor.z, parameters.endColor.w - parameters.startColor.w);
+    style.startScale = parameters.startScale;
+    style.deltaScale = parameters.endScale - parameters.startScale;
+    style.startSprite = parameters.startSprite;
+    style.deltaSprite = (i32)parameters.endSprite - (i32)parameters.startSprite;
 
-    particle.pos = parameters.pos;
-    particle.vel = parameters.vel;
-    particle.acceleration = parameters.acceleration;
-    particle.dampening = parameters.dampening;
+    std::pair<u32, u32> range(min(parameters.startSprite, parameters.endSprite), max(parameters.startSprite, parameters.endSprite));
+    if (std::find(spriteRanges.begin(), spriteRanges.end(), range) == spriteRanges.end()) {
+        spriteRanges.push_back(range);
+    }
+
+    for (u32 n = 0; n < amount; n++) {
+        u32 i;
+        if (count < maxParticles) {
+            i = count++;
+        } else {
+            i = nextReplaced;
+            nextReplaced = (nextReplaced + 1) % maxParticles;
+        }
 
-    particle.startColor = parameters.startColor;
-    particle.endColor = parameters.endColor;
-    particle.startScale = parameters.startScale;
-    particle.endScale = parameters.endScale;
-    particle.angle = rndf(parameters.minAngle, parameters.maxAngle);
-    particle.rotation = rndf(parameters.minRotation, parameters.maxRotation);
+        posX[i] = parameters.pos.x;
+        posY[i] = parameters.pos.y;
+        posZ[i] = parameters.pos.z;
+        velX[i] = parameters.vel.x;
+        velY[i] = parameters.vel.y;
+        velZ[i] = parameters.vel.z;
+        accelerationX[i] = parameters.acceleration.x;
+        accelerationY[i] = parameters.acceleration.y;
+        accelerationZ[i] = parameters.acceleration.z;
+        dampening[i] = parameters.dampening;
 
-    particle.startSprite = parameters.startSprite;
-    particle.endSprite = parameters.endSprite;
+        angle[i] = random.rndf(parameters.minAngle, parameters.maxAngle);
+        rotation[i] = random.rndf(parameters.minRotation, parameters.maxRotation);
 
-    particle.lifetime = rnd(parameters.minLifetime, parameters.maxLifetime);
-    particle.lifetimeRemaining = particle.lifetime;
+        i32 lifetime = random.rnd((i32)parameters.minLifetime, (i32)parameters.maxLifetime);
+        lifetimeRemaining[i] = lifetime;
 
-    nextParticle = (nextParticle + 1) % maxParticles;
+        rank[i] = NEW_PARTICLE;
+        styles[i] = style;
+        styles[i].inverseLifetime = lifetime > 0 ? 1.0f / (f32)lifetime : 0.0f;
+    }
 
     active = true;
 }
 
+void ParticleSystem::move(u32 from, u32 to) {
+    posX[to] = posX[from];
+    posY[to] = posY[from];
+    posZ[to] = posZ[from];
+    velX[to] = velX[from];
+    velY[to] = velY[from];
+    velZ[to] = velZ[from];
+    accelerationX[to] = accelerationX[from];
+    accelerationY[to] = accelerationY[from];
+    accelerationZ[to] = accelerationZ[from];
+    dampening[to] = dampening[from];
+    angle[to] = angle[from];
+    rotation[to] = rotation[from];
+    lifetimeRemaining[to] = lifetimeRemaining[from];
+    rank[to] = rank[from];
+    styles[to] = styles[from];
+}
+
+void ParticleSystem::integrate() {
+#ifdef AB_PARTICLES_SSE2
+    const __m128i one = _mm_set1_epi32(1);
+    for (u32 i = 0; i < count; i += 4) {
+        __m128 vx = _mm_loadu_ps(&velX[i]);
+        __m128 vy = _mm_loadu_ps(&velY[i]);
+        __m128 vz = _mm_loadu_ps(&velZ[i]);
+
+        _mm_storeu_ps(&posX[i], _mm_add_ps(_mm_loadu_ps(&posX[i]), vx));
+        _mm_storeu_ps(&posY[i], _mm_add_ps(_mm_loadu_ps(&posY[i]), vy));
+        _mm_storeu_ps(&posZ[i], _mm_add_ps(_mm_loadu_ps(&posZ[i]), vz));
+
+        __m128 damp = _mm_loadu_ps(&dampening[i]);
+        vx = _mm_mul_ps(_mm_add_ps(vx, _mm_loadu_ps(&accelerationX[i])), damp);
+        vy = _mm_mul_ps(_mm_add_ps(vy, _mm_loadu_ps(&accelerationY[i])), damp);
+        vz = _mm_mul_ps(_mm_add_ps(vz, _mm_loadu_ps(&accelerationZ[i])), damp);
+        _mm_storeu_ps(&velX[i], vx);
+        _mm_storeu_ps(&velY[i], vy);
+        _mm_storeu_ps(&velZ[i], vz);
+
+        _mm_storeu_ps(&angle[i], _mm_add_ps(_mm_loadu_ps(&angle[i]), _mm_loadu_ps(&rotation[i])));
+
+        __m128i* remaining = reinterpret_cast<__m128i*>(&lifetimeRemaining[i]);
+        _mm_storeu_si128(remaining, _mm_sub_epi32(_mm_loadu_si128(remaining), one));
+    }
+#else
+    integrateScalar();
+#endif
+}
+
+void ParticleSystem::integrateScalar() {
+    for (u32 i = 0; i < count; i++) {
+        posX[i] += velX[i];
+        posY[i] += velY[i];
+        posZ[i] += velZ[i];
+
+        velX[i] = (velX[i] + accelerationX[i]) * dampening[i];
+        velY[i] = (velY[i] + accelerationY[i]) * dampening[i];
+        velZ[i] = (velZ[i] + accelerationZ[i]) * dampening[i];
+
+        angle[i] += rotation[i];
+
+        lifetimeRemaining[i]--;
+    }
+}
+
 void ParticleSystem::update() {
-    active = false;
-    for (auto& particle : particles) {
-        if (particle.lifetimeRemaining <= 0) {
-            continue;
+    integrate();
+
+    //    swap the expired ones out, keeping the live ones packed
+    for (u32 i = 0; i < count;) {
+        if (lifetimeRemaining[i] <= 0) {
+            count--;
+            if (i != count) {
+                move(count, i);
+            }
+        } else {
+            i++;
         }
+    }
+    if (nextReplaced >= count) {
+        nextReplaced = 0;
+    }
+    if (count == 0) {
+        spriteRanges.clear();
+    }
 
-        active = true;
+    active = count > 0;
+}
 
-        particle.pos += particle.vel;
-        particle.vel += particle.acceleration;
-        particle.vel *= particle.dampening;
-        particle.angle += particle.rotation;
- 
-        particle.lifetimeRemaining--;
+void ParticleSystem::resolveSprites() {
+    for (auto& range : spriteRanges) {
+        if (range.second >= spriteTable.size()) {
+            spriteTable.resize(range.second + 1, nullptr);
+        }
+        for (u32 index = range.first; index <= range.second; index++) {
+            Sprite *sprite = sprites.get(index);
+            if (sprite->texture.get() == 0) {
+                sprite->uploadToGPU();
+            }
+            spriteTable[index] = sprite;
+        }
     }
 }
 
-void ParticleSystem::render(RenderLayer *renderLayer, PerspectiveCamera const& camera) {
-    //  calculate viewspace depth for each particle and sort
-    for (auto& particle : particles) {
-        Mat4 view = camera.viewMatrix;
-        particle.depth = (view * particle.pos).z;
-    }
-    std::sort(particles.begin(), particles.end(),
-        [](const Particle& a, const Particle& b) {
-            return a.depth < b.depth;
-        });
-
-    for (auto& particle : particles) {
-        if (particle.lifetimeRemaining <= 0) {
-            continue;
+void ParticleSystem::sortByDepth(PerspectiveCamera const& camera) {
+    //  view space depth is just the third row of the view matrix
+    const Mat4& view = camera.viewMatrix;
+    f32 zx = view.data2d[0][2], zy = view.data2d[1][2], zz = view.data2d[2][2], zw = view.data2d[3][2];
+
+    depths.resize(count);
+    f32 nearest = FLT_MAX, farthest = -FLT_MAX;
+    for (u32 i = 0; i < count; i++) {
+        f32 depth = zx * posX[i] + zy * posY[i] + zz * posZ[i] + zw;
+        depths[i] = depth;
+        nearest = min(nearest, depth);
+        farthest = max(farthest, depth);
+    }
+
+    //  16 bits of depth across the system is plenty to order sprites, and lets the radix sort
+    //  skip the upper passes
+    f32 quantize = farthest > nearest ? 65535.0f / (farthest - nearest) : 0.0f;
+    auto key = [&](u32 i) {
+        return (u64)((depths[i] - nearest) * quantize);
+    };
+
+    //  last frame's order, minus the particles that have died since
+    rankedSlots.assign(rankedCount, NEW_PARTICLE);
+    newKeys.clear();
+    for (u32 i = 0; i < count; i++) {
+        if (rank[i] < rankedCount) {
+            rankedSlots[rank[i]] = i;
+        } else {
+            newKeys.push_back({ key(i), i });
         }
+    }
+    sortKeys.clear();
+    for (u32 slot : rankedSlots) {
+        if (slot != NEW_PARTICLE) {
+            sortKeys.push_back({ key(slot), slot });
+        }
+    }
 
-        f32 life = 1.0f - ((f32)particle.lifetimeRemaining / (f32)particle.lifetime);
+    //  about what a radix sort would cost
+    u32 survivors = sortKeys.size();
+    if (insertionSort(sortKeys.data(), survivors, survivors * 2 + 64)) {
+        if (!newKeys.empty()) {
+            radixSort(newKeys, sortScratch);
+            sortScratch.resize(count);
+            std::merge(sortKeys.begin(), sortKeys.end(), newKeys.begin(), newKeys.end(), sortScratch.begin(),
+                [](const SortKey& a, const SortKey& b) {
+                    return a.key < b.key;
+                });
+            sortKeys.swap(sortScratch);
+        }
+    } else {
+        sortKeys.insert(sortKeys.end(), newKeys.begin(), newKeys.end());
+        radixSort(sortKeys, sortScratch);
+    }
+
+    for (u32 k = 0; k < count; k++) {
+        rank[sortKeys[k].index] = k;
+    }
+    rankedCount = count;
+}
+
+void ParticleSystem::buildInstances(PerspectiveCamera const& camera) {
+    instances.clear();
+    if (count == 0) {
+        return;
+    }
 
-        extern AssetManager<Sprite> sprites;
-        u32 spriteIndex = (u32)((particle.endSprite - particle.startSprite) * life) + particle.startSprite;
-        Sprite* sprite = sprites.get(spriteIndex);
+    sortByDepth(camera);
 
-        f32 scale = ((particle.endScale - particle.startScale) * life) + particle.startScale;
-        f32 hScale = (1.0f / sprite->width) * scale;
-        f32 vScale = (1.0f / sprite->height) * scale;
+    instances.resize(count);
+    for (u32 k = 0; k < count; k++) {
+        u32 i = sortKeys[k].index;
+        const Style& style = styles[i];
 
-        Vec4 color = ((particle.endColor - particle.startColor) * life) + particle.startColor;
+        f32 life = 1.0f - (f32)lifetimeRemaining[i] * style.inverseLifetime;
 
-        sprite->render(renderLayer, particle.pos, particle.angle, AB::Vec2(hScale, vScale), color);
+        //    deltaSprite runs backwards when endSprite < startSprite, so stay signed until the sum
+        u32 spriteIndex = (u32)((i32)(style.deltaSprite * life) + style.startSprite);
+        Sprite *sprite = spriteTable[spriteIndex];
+
+        f32 scale = style.deltaScale * life + style.startScale;
+
+        instances[k] = sprite->makeQuad(Vec3(posX[i], posY[i], posZ[i]), angle[i], Vec2(scale / sprite->width, scale / sprite->height),
+            Vec4(style.deltaColor.x * life + style.startColor.x, style.deltaColor.y * life + style.startColor.y,
+            style.deltaColor.z * life + style.startColor.z, style.deltaColor.w * life + style.startColor.w));
     }
 }
 
-}    //  namespace
+void ParticleSystem::render(RenderLayer *renderLayer, PerspectiveCamera const& camera) {
+    resolveSprites();
+    buildInstances(camera);
+    renderLayer->quadBatch.insert(renderLayer->quadBatch.end(), instances.begin(), instances.end());
+}
 
+}    //  namespace
@@ -26,11 +26,15 @@ freely, subject to the following restrictions:
 #define AB_PARTICLE_SYSTEM_H
 
 #include "../math/vector.h"
+#include "../math/random.h"
 #include "renderLayer.h"
 #include "camera.h"
+#include "../misc/radixSort.h"
 
 namespace AB {
 
+class Sprite;
+
 struct ParticleParameters {
     Vec3 pos, vel, acceleration;
     f32 dampening = 1.0f;
@@ -43,31 +47,86 @@ struct ParticleParameters {
     u32 minLifetime, maxLifetime;
 };
 
+//  Particles are kept as structure of arrays with the live ones packed at the front, so update
+//  only touches live particles, four at a time with SSE2, and dead ones are swapped out with the
+//  last live one. Fields only needed for drawing are kept apart from the ones update() runs over.
 class ParticleSystem {
     public:
-        ParticleSystem(u32 maxParticles = 512);
+        //    each system draws from its own random stream, so what it does doesn't depend on what
+        //    other systems (or threads) did first. a seed of 0 takes one from the global generator,
+        //    which is still reproducible when the seed is pinned for record / replay
+        ParticleSystem(u32 maxParticles = 512, u32 seed = 0);
         virtual ~ParticleSystem() = default;
 
-        void emit(ParticleParameters const& parameters);
+        //    when the system is full new particles take the place of existing ones, round robin
+        void emit(ParticleParameters const& parameters, u32 amount = 1);
+
+        //    only touches this system, so different systems can be updated on different threads
         virtual void update();
+
+        //    resolveSprites() has to run on the main thread, it can load assets. buildInstances()
+        //    then sorts and fills getInstances() and is safe to run alongside other systems.
+        //    render() does both and queues the result
+        void resolveSprites();
+        void buildInstances(PerspectiveCamera const& camera);
+        const std::vector<RenderLayer::Quad>& getInstances() const { return instances; }
         void render(RenderLayer *renderLayer, PerspectiveCamera const& camera);
 
+        u32 getCount() const { return count; }
+        u32 getMaxParticles() const { return maxParticles; }
+
         b8 active;
 
     protected:
-        struct Particle {
-            Vec3 pos, vel, acceleration;
-            f32 dampening;
-            Vec4 startColor, endColor;
-            f32 startScale, endScale;
-            f32 angle, rotation;
-            i32 startSprite, endSprite;
-            i32 lifetime, lifetimeRemaining;
-            f32 depth;
+        //    updated every tick. sized to a multiple of 4 so the SIMD loop never needs a tail,
+        //    whatever's past count is garbage
+        std::vector<f32> posX, posY, posZ;
+        std::vector<f32> velX, velY, velZ;
+        std::vector<f32> accelerationX, accelerationY, accelerationZ;
+        std::vector<f32> dampening;
+        std::vector<f32> angle, rotation;
+        std::vector<i32> lifetimeRemaining;
+
+        //    where each particle came in the last sorted order, NEW_PARTICLE if it's new since
+        std::vector<u32> rank;
+        static constexpr u32 NEW_PARTICLE = 0xFFFFFFFF;
+
+        //    only read when drawing. stored as start + delta so interpolating is a multiply-add
+        struct Style {
+            Vec4 startColor, deltaColor;
+            f32 startScale, deltaScale;
+            i32 startSprite, deltaSprite;
+            f32 inverseLifetime;
         };
-        std::vector<Particle> particles;
-        u32 maxParticles, nextParticle;
-
+        std::vector<Style> styles;
+
+        u32 maxParticles, count, nextReplaced;
+
+        PRNG random;
+
+        void move(u32 from, u32 to);
+
+        //    moves every live particle on a tick. integrate() runs four at a time with SSE2 where
+        //    it's available, and has to agree exactly with integrateScalar()
+        void integrate();
+        void integrateScalar();
+
+    private:
+        //    particles barely move relative to each other between frames, so last frame's order
+        //    is the starting point. survivors are insertion sorted, new particles sorted on their
+        //    own and merged in, with a full radix sort when too much has changed
+        void sortByDepth(PerspectiveCamera const& camera);
+
+        //    render() working space, kept between frames
+        std::vector<SortKey> sortKeys;
+        std::vector<SortKey> newKeys;
+        std::vector<SortKey> sortScratch;
+        std::vector<u32> rankedSlots;
+        std::vector<f32> depths;
+        u32 rankedCount = 0;
+        std::vector<Sprite*> spriteTable;      //    by sprite index, filled for spriteRanges
+        std::vector<std::pair<u32, u32>> spriteRanges;
+        std::vector<RenderLayer::Quad> instances;
 };
 
 }   //  namespace
@@ -0,0 +1,91 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#include "pixelConvert.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AB_PIXELS_SSE2
+#endif
+
+namespace AB {
+
+void convertBGRAScalar(u8* destination, const u8* source, u32 count) {
+    for (u32 i = 0; i < count; i++, source += 4, destination += 4) {
+        u32 alpha = source[3];
+        u8 red = premultiply(source[2], alpha);
+        u8 green = premultiply(source[1], alpha);
+        u8 blue = premultiply(source[0], alpha);
+
+        //  source and destination may be the same
+        destination[0] = red;
+        destination[1] = green;
+        destination[2] = blue;
+        destination[3] = (u8)alpha;
+    }
+}
+
+void convertBGRA(u8* destination, const u8* source, u32 count) {
+#ifdef AB_PIXELS_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i half = _mm_set1_epi16(128);
+
+    //  multiply alpha by 255 so the same rounding hands it back unchanged
+    const __m128i alphaLane = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    const __m128i opaque = _mm_and_si128(_mm_set1_epi16(255), alphaLane);
+
+    u32 blocks = count / 4;
+    for (u32 i = 0; i < blocks; i++, source += 16, destination += 16) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*)source);
+
+        //  two pixels per half, one 16 bit lane per channel
+        __m128i halves[2] = { _mm_unpacklo_epi8(pixels, zero), _mm_unpackhi_epi8(pixels, zero) };
+        for (u32 h = 0; h < 2; h++) {
+            //  BGRA -> RGBA, and alpha copied into every lane of its pixel
+            __m128i rgba = _mm_shufflehi_epi16(_mm_shufflelo_epi16(halves[h], _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+            __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(halves[h], _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            alpha = _mm_or_si128(_mm_andnot_si128(alphaLane, alpha), opaque);
+
+            __m128i t = _mm_add_epi16(_mm_mullo_epi16(rgba, alpha), half);
+            halves[h] = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+        }
+
+        _mm_storeu_si128((__m128i*)destination, _mm_packus_epi16(halves[0], halves[1]));
+    }
+    count -= blocks * 4;
+#endif
+
+    convertBGRAScalar(destination, source, count);
+}
+
+void convertBGR(u8* destination, const u8* source, u32 count) {
+    for (u32 i = 0; i < count; i++, source += 3, destination += 4) {
+        destination[0] = source[2];
+        destination[1] = source[1];
+        destination[2] = source[0];
+        destination[3] = 255;
+    }
+}
+
+}   //  namespace
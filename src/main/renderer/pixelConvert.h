@@ -0,0 +1,51 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#ifndef AB_PIXEL_CONVERT_H
+#define AB_PIXEL_CONVERT_H
+
+#include "../types.h"
+
+namespace AB {
+
+//  Turns TGA pixels (BGR or BGRA) into the premultiplied RGBA that Image holds, in one pass.
+//  Premultiplying is integer math, rounded to nearest, which gives the same bytes the old float
+//  version did. 32 bit pixels go four at a time through SSE2 where it's there; the Scalar
+//  version gives identical results and is always available.
+
+inline u8 premultiply(u32 color, u32 alpha) {
+    //  round(color * alpha / 255) without a divide
+    u32 t = color * alpha + 128;
+    return (u8)((t + (t >> 8)) >> 8);
+}
+
+void convertBGRA(u8* destination, const u8* source, u32 count);
+void convertBGRAScalar(u8* destination, const u8* source, u32 count);
+
+//  no alpha to premultiply by, so this is only a swizzle
+void convertBGR(u8* destination, const u8* source, u32 count);
+
+}   //  namespace
+
+#endif // AB_PIXEL_CONVERT_H
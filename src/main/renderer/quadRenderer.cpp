@@ -25,15 +25,23 @@ freely, subject to the following restrictions:
 #include "../pch.h"
 
 #include "quadRenderer.h"
+#include "renderState.h"
+#include "renderThread.h"
+#include "renderer.h"
 #include "../math/math.h"
+#include "../math/frustum.h"
+#include "../core/log.h"
 
 namespace AB {
 
+extern Renderer renderer;
+
 Shader QuadRenderer::defaultQuadShader;
 
 static bool initialized = false;
 
 QuadRenderer::QuadRenderer(Shader *quadShader) {
+    syncRenderThread();
     if (!initialized) {
         defaultQuadShader.load("shaders/quadRenderer");
 
@@ -43,12 +51,16 @@ QuadRenderer::QuadRenderer(Shader *quadShader) {
     setFog();
 
     CALL_GL(glGenVertexArrays(1, &batchVAO));
-    CALL_GL(glBindVertexArray(batchVAO));
+    renderState.bindVertexArray(batchVAO);
+
+    vertexBuffer.init(GL_ARRAY_BUFFER, MAX_VERTICES * sizeof(Vertex));
+    setVertexAttributes();
 
-    CALL_GL(glGenBuffers(1, &batchVBO));
-    CALL_GL(glBindBuffer(GL_ARRAY_BUFFER, batchVBO));
-    CALL_GL(glBufferData(GL_ARRAY_BUFFER, MAX_VERTICES * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW));
+    renderState.bindVertexArray(0);
+}
 
+//  points the attributes of the bound vertex array at the bound array buffer
+void QuadRenderer::setVertexAttributes() {
     //  position (location 0)
     CALL_GL(glEnableVertexAttribArray(0));
     CALL_GL(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, px)));
@@ -64,11 +76,10 @@ QuadRenderer::QuadRenderer(Shader *quadShader) {
     //  color (location 3)
     CALL_GL(glEnableVertexAttribArray(3));
     CALL_GL(glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, r)));
-
-    CALL_GL(glBindVertexArray(0));
 }
 
 QuadRenderer::~QuadRenderer() {
+    syncRenderThread();
     if (initialized) {
         defaultQuadShader.release();
 
@@ -76,23 +87,21 @@ QuadRenderer::~QuadRenderer() {
     }
 
     CALL_GL(glDeleteBuffers(1, &batchVAO));
-    CALL_GL(glDeleteBuffers(1, &batchVBO));
+    vertexBuffer.release();
+
+    releaseStatic();
 }
 
 void QuadRenderer::setFog(AB::Vec3 color, f32 density) {
+    syncRenderThread();
     quadShader->setVec3("uFogColor", color);
     quadShader->setFloat("uFogDensity", density);
 }
 
-void QuadRenderer::addQuad(Quad3d& quad) {
-    static const int indices[6] = { 0, 1, 2, 2, 3, 0};
-
-    batches[quad.textureID].reserve(batches[quad.textureID].size() + 6);
-    quad.calculateNormal();
-
-    for (u32 i = 0; i < 6; i++) {
+void QuadRenderer::pushVertices(std::vector<Vertex>& vertices, Quad3d& quad, const int* order, u32 count) {
+    for (u32 i = 0; i < count; i++) {
         Vertex v;
-        u32 index = indices[i];
+        u32 index = order[i];
         v.px = quad.v[index].x;
         v.py = quad.v[index].y;
         v.pz = quad.v[index].z;
@@ -105,18 +114,274 @@ void QuadRenderer::addQuad(Quad3d& quad) {
         v.g = quad.color.g;
         v.b = quad.color.b;
         v.a = quad.color.a;
-        batches[quad.textureID].push_back(v);
+        vertices.push_back(v);
+    }
+}
+
+void QuadRenderer::addQuad(Quad3d& quad) {
+    static const int indices[6] = { 0, 1, 2, 2, 3, 0};
+
+    if (recordingStatic) {
+        staticQuads.push_back(quad);
+        return;
+    }
+
+    batches[quad.textureID].reserve(batches[quad.textureID].size() + 6);
+    quad.calculateNormal();
+    pushVertices(batches[quad.textureID], quad, indices, 6);
+}
+
+void QuadRenderer::beginStatic() {
+    recordingStatic = true;
+    staticQuads.clear();
+}
+
+void QuadRenderer::endStatic() {
+    syncRenderThread();
+    recordingStatic = false;
+
+    nodes.clear();
+    nodeChildren.clear();
+    childBounds.clear();
+    chunks.clear();
+    draws.clear();
+
+    if (staticQuads.empty()) {
+        return;
+    }
+
+    for (auto& quad : staticQuads) {
+        quad.calculateNormal();
+        quad.calculateExtents();
+    }
+
+    std::vector<u32> quadIndices(staticQuads.size());
+    for (u32 i = 0; i < quadIndices.size(); i++) {
+        quadIndices[i] = i;
+    }
+
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> elements;
+    vertices.reserve(staticQuads.size() * 4);
+    elements.reserve(staticQuads.size() * 6);
+
+    buildNode(quadIndices, 0, vertices, elements);
+
+    if (!staticVAO) {
+        CALL_GL(glGenVertexArrays(1, &staticVAO));
+        CALL_GL(glGenBuffers(1, &staticVBO));
+        CALL_GL(glGenBuffers(1, &staticEBO));
+    }
+    renderState.bindVertexArray(staticVAO);
+
+    CALL_GL(glBindBuffer(GL_ARRAY_BUFFER, staticVBO));
+    CALL_GL(glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW));
+    setVertexAttributes();
+
+    //    the element buffer binding is part of the vertex array's state
+    CALL_GL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, staticEBO));
+    CALL_GL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, elements.size() * sizeof(GLuint), elements.data(), GL_STATIC_DRAW));
+
+    renderState.bindVertexArray(0);
+
+    LOG("Baked %d static quads into %d chunks", (i32)staticQuads.size(), (i32)chunks.size());
+
+    staticQuads.clear();
+    staticQuads.shrink_to_fit();
+}
+
+void QuadRenderer::releaseStatic() {
+    syncRenderThread();
+
+    if (staticVAO) {
+        CALL_GL(glDeleteVertexArrays(1, &staticVAO));
+        CALL_GL(glDeleteBuffers(1, &staticVBO));
+        CALL_GL(glDeleteBuffers(1, &staticEBO));
+        staticVAO = staticVBO = staticEBO = 0;
+    }
+    nodes.clear();
+    nodeChildren.clear();
+    childBounds.clear();
+    chunks.clear();
+    draws.clear();
+}
+
+u32 QuadRenderer::buildNode(std::vector<u32>& quadIndices, u32 depth, std::vector<Vertex>& vertices, std::vector<GLuint>& elements) {
+    OctreeNode node;
+    node.bounds.min = staticQuads[quadIndices[0]].min;
+    node.bounds.max = staticQuads[quadIndices[0]].max;
+    for (u32 index : quadIndices) {
+        const Quad3d& quad = staticQuads[index];
+        node.bounds.min = Vec3(min(node.bounds.min.x, quad.min.x), min(node.bounds.min.y, quad.min.y), min(node.bounds.min.z, quad.min.z));
+        node.bounds.max = Vec3(max(node.bounds.max.x, quad.max.x), max(node.bounds.max.y, quad.max.y), max(node.bounds.max.z, quad.max.z));
+    }
+    node.bounds.calculateCenter();
+    node.firstChild = 0;
+    node.childCount = 0;
+    node.chunk = -1;
+
+    u32 nodeIndex = nodes.size();
+    nodes.push_back(node);
+
+    if (quadIndices.size() <= MAX_QUADS_PER_CHUNK || depth >= MAX_OCTREE_DEPTH) {
+        nodes[nodeIndex].chunk = buildChunk(quadIndices, vertices, elements);
+        return nodeIndex;
+    }
+
+    //    quads go to whichever octant holds their center
+    std::array<AABB, 8> octants = node.bounds.subdivideOctants();
+    std::vector<u32> buckets[8];
+    u32 used = 0;
+    for (u32 index : quadIndices) {
+        Quad3d& quad = staticQuads[index];
+        Vec3 center = (quad.min + quad.max) / 2.0f;
+
+        for (u32 i = 0; i < 8; i++) {
+            if (center.x <= octants[i].max.x && center.y <= octants[i].max.y && center.z <= octants[i].max.z &&
+                center.x >= octants[i].min.x && center.y >= octants[i].min.y && center.z >= octants[i].min.z) {
+                if (buckets[i].empty()) {
+                    used++;
+                }
+                buckets[i].push_back(index);
+                break;
+            }
+        }
+    }
+
+    //    everything piled up in one spot, splitting further won't help
+    if (used < 2) {
+        nodes[nodeIndex].chunk = buildChunk(quadIndices, vertices, elements);
+        return nodeIndex;
+    }
+
+    u32 children[8];
+    u32 childCount = 0;
+    for (u32 i = 0; i < 8; i++) {
+        if (!buckets[i].empty()) {
+            children[childCount++] = buildNode(buckets[i], depth + 1, vertices, elements);
+        }
+    }
+
+    nodes[nodeIndex].firstChild = nodeChildren.size();
+    nodes[nodeIndex].childCount = childCount;
+    nodeChildren.insert(nodeChildren.end(), children, children + childCount);
+    for (u32 i = 0; i < childCount; i++) {
+        childBounds.add(nodes[children[i]].bounds);
+    }
+
+    return nodeIndex;
+}
+
+i32 QuadRenderer::buildChunk(std::vector<u32>& quadIndices, std::vector<Vertex>& vertices, std::vector<GLuint>& elements) {
+    static const int corners[4] = { 0, 1, 2, 3 };
+
+    std::stable_sort(quadIndices.begin(), quadIndices.end(), [this](u32 a, u32 b) {
+        return staticQuads[a].textureID < staticQuads[b].textureID;
+    });
+
+    StaticChunk chunk;
+    chunk.firstDraw = draws.size();
+    chunk.drawCount = 0;
+
+    for (u32 index : quadIndices) {
+        Quad3d& quad = staticQuads[index];
+
+        if (chunk.drawCount == 0 || draws.back().textureID != quad.textureID) {
+            StaticDraw draw;
+            draw.textureID = quad.textureID;
+            draw.firstIndex = elements.size();
+            draw.indexCount = 0;
+            draws.push_back(draw);
+            chunk.drawCount++;
+        }
+
+        GLuint base = vertices.size();
+        pushVertices(vertices, quad, corners, 4);
+
+        elements.push_back(base + 0);
+        elements.push_back(base + 1);
+        elements.push_back(base + 2);
+        elements.push_back(base + 2);
+        elements.push_back(base + 3);
+        elements.push_back(base + 0);
+        draws.back().indexCount += 6;
+    }
+
+    chunks.push_back(chunk);
+    return chunks.size() - 1;
+}
+
+void QuadRenderer::renderStatic(const PerspectiveCamera& camera) {
+    visibleChunks = 0;
+    if (nodes.empty()) {
+        return;
+    }
+
+    PerspectiveCamera frustumCamera = camera;
+    Frustum frustum = frustumCamera.generateFrustum();
+
+    renderState.bindVertexArray(staticVAO);
+
+    if (!frustum.boxInFrustum(nodes[0].bounds)) {
+        return;
+    }
+
+    GLuint boundTexture = 0;
+    traversal.clear();
+    traversal.push_back(0);
+
+    //    everything on the stack is already known to be visible. children are culled
+    //    together, straight out of childBounds
+    while (!traversal.empty()) {
+        OctreeNode& node = nodes[traversal.back()];
+        traversal.pop_back();
+
+        if (node.chunk == -1) {
+            u32 visibility;
+            u32 first = node.firstChild;
+            cullBoxes(frustum, &childBounds.minX[first], &childBounds.minY[first], &childBounds.minZ[first],
+                &childBounds.maxX[first], &childBounds.maxY[first], &childBounds.maxZ[first], node.childCount, &visibility);
+
+            for (u32 i = 0; i < node.childCount; i++) {
+                if (isVisible(&visibility, i)) {
+                    traversal.push_back(nodeChildren[first + i]);
+                }
+            }
+            continue;
+        }
+
+        const StaticChunk& chunk = chunks[node.chunk];
+        for (u32 i = chunk.firstDraw; i < chunk.firstDraw + chunk.drawCount; i++) {
+            const StaticDraw& draw = draws[i];
+
+            if (draw.textureID != boundTexture) {
+                CALL_GL(glBindTexture(GL_TEXTURE_2D, draw.textureID));
+                boundTexture = draw.textureID;
+            }
+            CALL_GL(glDrawElements(GL_TRIANGLES, draw.indexCount, GL_UNSIGNED_INT, (void*)(draw.firstIndex * sizeof(GLuint))));
+            renderState.stats.drawCalls++;
+        }
+        visibleChunks++;
     }
 }
 
 void QuadRenderer::render(const PerspectiveCamera& camera) {
+    renderer.beginDirectDraw();
     quadShader->bind();
-    quadShader->setMat4("uProjView", camera.viewProjectionMatrix);
-    quadShader->setMat4("uView", camera.viewMatrix);
+    if (quadShader != uniformShader) {
+        projViewUniform = quadShader->getUniform("uProjView");
+        viewUniform = quadShader->getUniform("uView");
+        uniformShader = quadShader;
+    }
+    quadShader->setMat4(projViewUniform, camera.viewProjectionMatrix);
+    quadShader->setMat4(viewUniform, camera.viewMatrix);
 
-    CALL_GL(glBindVertexArray(batchVAO));
-    CALL_GL(glBindBuffer(GL_ARRAY_BUFFER, batchVBO));
+    renderStatic(camera);
 
+    renderState.bindVertexArray(batchVAO);
+
+    //    stream in whole quads, MAX_VERTICES at most at a time
+    const u32 MAX_CHUNK_VERTICES = MAX_VERTICES / 6 * 6;
     for (auto& [textureID, verts] : batches) {
         if (verts.empty()) {
             continue;
@@ -124,11 +389,15 @@ void QuadRenderer::render(const PerspectiveCamera& camera) {
 
         CALL_GL(glBindTexture(GL_TEXTURE_2D, textureID));
 
-        u32 vertexCount = min((u32)verts.size(), MAX_VERTICES);
-        CALL_GL(glBufferSubData(GL_ARRAY_BUFFER, 0, vertexCount * sizeof(Vertex), verts.data()));
-        CALL_GL(glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertexCount));
+        for (u32 first = 0; first < verts.size(); first += MAX_CHUNK_VERTICES) {
+            u32 vertexCount = min((u32)verts.size() - first, MAX_CHUNK_VERTICES);
+            size_t offset = vertexBuffer.upload(&verts[first], vertexCount * sizeof(Vertex), sizeof(Vertex));
+            CALL_GL(glDrawArrays(GL_TRIANGLES, (GLint)(offset / sizeof(Vertex)), (GLsizei)vertexCount));
+            renderState.stats.drawCalls++;
+        }
     }
-    CALL_GL(glBindVertexArray(0));
+    renderState.bindVertexArray(0);
+    vertexBuffer.advanceFrame();
     batches.clear();
 }
 
@@ -26,9 +26,16 @@ freely, subject to the following restrictions:
 #define AB_QUAD_RENDERER_H
 
 #include "renderLayer.h"
+#include "../math/aabb.h"
+#include "../math/batchCulling.h"
 
 //  Intended to serve as a base for rendering static level geometry in
-//  conjunction with some higher-level VSD algorithm
+//  conjunction with some higher-level VSD algorithm.
+//
+//  Quads added between beginStatic() and endStatic() are baked once into indexed vertex
+//  buffers that stay on the GPU. They're split into chunks by an octree over their bounds and
+//  render() only draws the chunks whose box is in the camera's frustum. Quads added outside of
+//  that are streamed and drawn every frame as before.
 
 namespace AB {
 
@@ -74,8 +81,21 @@ class QuadRenderer : public RenderLayer {
         void setFog(AB::Vec3 color = AB::Vec3(0.0f, 0.0f, 0.0f), f32 density = 0.15f);
 
         void addQuad(Quad3d& quad);
+        //    draws right away, to the screen only (see Renderer::beginDirectDraw)
         void render(const PerspectiveCamera& camera);
 
+        //    static geometry. endStatic() replaces whatever was baked before
+        void beginStatic();
+        void endStatic();
+        void releaseStatic();
+
+        u32 getChunkCount() const { return chunks.size(); }
+        u32 getVisibleChunkCount() const { return visibleChunks; }
+
+        //    octree leaves hold up to this many quads, unless they're already this deep
+        static constexpr u32 MAX_QUADS_PER_CHUNK = 1024;
+        static constexpr u32 MAX_OCTREE_DEPTH = 8;
+
         Shader *quadShader;
         static AB::Shader defaultQuadShader;
 
@@ -88,6 +108,51 @@ class QuadRenderer : public RenderLayer {
         };
 
         std::unordered_map<GLuint, std::vector<Vertex>> batches;
+        StreamBuffer vertexBuffer;
+
+        void setVertexAttributes();
+        static void pushVertices(std::vector<Vertex>& vertices, Quad3d& quad, const int* order, u32 count);
+
+        //    static geometry
+        struct OctreeNode {
+            AABB bounds;        //    tight around the quads below
+            u32 firstChild;     //    into nodeChildren
+            u32 childCount;
+            i32 chunk;          //    leaves only, -1 otherwise
+        };
+        struct StaticDraw {
+            GLuint textureID;
+            u32 firstIndex;
+            u32 indexCount;
+        };
+        struct StaticChunk {
+            u32 firstDraw;
+            u32 drawCount;
+        };
+
+        u32 buildNode(std::vector<u32>& quadIndices, u32 depth, std::vector<Vertex>& vertices, std::vector<GLuint>& elements);
+        i32 buildChunk(std::vector<u32>& quadIndices, std::vector<Vertex>& vertices, std::vector<GLuint>& elements);
+        void renderStatic(const PerspectiveCamera& camera);
+
+        b8 recordingStatic = false;
+        std::vector<Quad3d> staticQuads;
+
+        std::vector<OctreeNode> nodes;
+        std::vector<u32> nodeChildren;
+        AABBArray childBounds;      //    parallel to nodeChildren
+        std::vector<StaticChunk> chunks;
+        std::vector<StaticDraw> draws;
+        std::vector<u32> traversal;
+        u32 visibleChunks = 0;
+
+        GLuint staticVAO = 0;
+        GLuint staticVBO = 0;
+        GLuint staticEBO = 0;
+
+        //    looked up again if quadShader is swapped out
+        Shader *uniformShader = nullptr;
+        Shader::Uniform projViewUniform;
+        Shader::Uniform viewUniform;
 
 };
 
@@ -25,6 +25,9 @@ freely, subject to the following restrictions:
 #include "../pch.h"
 
 #include "renderLayer.h"
+#include "textureArray.h"
+#include "renderState.h"
+#include "renderThread.h"
 
 namespace AB {
 
@@ -43,16 +46,25 @@ GLuint RenderLayer::quadElements[] = {
 };
 
 Shader RenderLayer::defaultBatchShader;
+Shader RenderLayer::defaultArrayBatchShader;
+Shader RenderLayer::defaultPackedBatchShader;
+Shader RenderLayer::defaultArrayPackedBatchShader;
 Shader RenderLayer::defaultShader;
 
 TextureCache RenderLayer::textureCache;
 
+static_assert(sizeof(RenderLayer::PackedQuad) == 32, "PackedQuad should be 32 bytes");
+
 static bool initialized = false;
 
-RenderLayer::RenderLayer(Shader *batchShader, Shader *shader, Mat4 colorTransform, bool depthSorting) {
+RenderLayer::RenderLayer(Shader *batchShader, Shader *shader, Mat4 colorTransform, bool depthSorting, bool textureArrays, bool packedInstances) {
+    syncRenderThread();
     //    load default shaders
     if (!initialized) {
         defaultBatchShader.load("shaders/instanced2d");
+        defaultArrayBatchShader.load("shaders/instanced2dArray");
+        defaultPackedBatchShader.load("shaders/instanced2dPacked");
+        defaultArrayPackedBatchShader.load("shaders/instanced2dArrayPacked");
         defaultShader.load("shaders/default2d");
 
         initialized = true;
@@ -62,7 +74,7 @@ RenderLayer::RenderLayer(Shader *batchShader, Shader *shader, Mat4 colorTransfor
 
     // create VAO
     CALL_GL(glGenVertexArrays(1, &batchVAO));
-    CALL_GL(glBindVertexArray(batchVAO));
+    renderState.bindVertexArray(batchVAO);
 
     // create vertex VBO
     CALL_GL(glGenBuffers(1, &batchVBO));
@@ -79,68 +91,56 @@ RenderLayer::RenderLayer(Shader *batchShader, Shader *shader, Mat4 colorTransfor
     CALL_GL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batchEBO));
     CALL_GL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * 6, &quadElements[0], GL_STATIC_DRAW));
 
-    // create IBO
-    CALL_GL(glGenBuffers(1, &batchIBO));
-    CALL_GL(glBindBuffer(GL_ARRAY_BUFFER, batchIBO));
-    CALL_GL(glBufferData(GL_ARRAY_BUFFER, sizeof(Quad) * MAX_QUADS_PER_BATCH, NULL, GL_DYNAMIC_DRAW));
-
-    // set instance attribute pointers
-
-    //        position
-    CALL_GL(glEnableVertexAttribArray(1));
-    CALL_GL(glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Quad), (void*)0));
-    CALL_GL(glVertexAttribDivisor(1, 1));
-
-    //        size
-    CALL_GL(glEnableVertexAttribArray(2));
-    CALL_GL(glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Quad), (void*)(sizeof(GLfloat) * 3)));
-    CALL_GL(glVertexAttribDivisor(2, 1));
-
-    //        scale
-    CALL_GL(glEnableVertexAttribArray(3));
-    CALL_GL(glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Quad), (void*)(sizeof(GLfloat) * 5)));
-    CALL_GL(glVertexAttribDivisor(3, 1));
-
-    //        rotation
-    CALL_GL(glEnableVertexAttribArray(4));
-    CALL_GL(glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(Quad), (void*)(sizeof(GLfloat) * 7)));
-    CALL_GL(glVertexAttribDivisor(4, 1));
+    // create IBO. instance data is streamed, so leave room for a few frames of big batches
+    instanceBuffer.init(GL_ARRAY_BUFFER, sizeof(Quad) * MAX_QUADS_PER_BATCH * 4);
 
-    //        uv
-    CALL_GL(glEnableVertexAttribArray(5));
-    CALL_GL(glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(Quad), (void*)(sizeof(GLfloat) * 8)));
-    CALL_GL(glVertexAttribDivisor(5, 1));
-
-    //        texture unit
-    CALL_GL(glEnableVertexAttribArray(6));
-    CALL_GL(glVertexAttribIPointer(6, 1, GL_INT, sizeof(Quad), (void*)(sizeof(GLfloat) * 12)));
-    CALL_GL(glVertexAttribDivisor(6, 1));
+    this->colorTransform = colorTransform;
+    this->depthSorting = depthSorting;
+    this->textureArrays = textureArrays;
+    this->packedInstances = packedInstances;
 
-    //        color
-    CALL_GL(glEnableVertexAttribArray(7));
-    CALL_GL(glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(Quad), (void*)(sizeof(GLfloat) * 12 + sizeof(GLint))));
-    CALL_GL(glVertexAttribDivisor(7, 1));
+    // instance attributes 1 - 7 advance once per quad
+    for (GLuint attribute = 1; attribute <= 7; attribute++) {
+        CALL_GL(glEnableVertexAttribArray(attribute));
+        CALL_GL(glVertexAttribDivisor(attribute, 1));
+    }
+    setInstanceAttributes(0);
 
     quadBatch.reserve(MAX_QUADS_PER_BATCH);
     quadBatch.clear();
 
-    this->colorTransform = colorTransform;
-    this->depthSorting = depthSorting;
-
     //    ------------ non-batch
 
     // allocate resources for immediate-mode emulation
     CALL_GL(glGenVertexArrays(1, &VAO));
-    CALL_GL(glBindVertexArray(VAO));
-    CALL_GL(glGenBuffers(1, &VBO));
+    renderState.bindVertexArray(VAO);
+    immediateVertexBuffer.init(GL_ARRAY_BUFFER, 64 * 1024);
+    immediateIndexBuffer.init(GL_ELEMENT_ARRAY_BUFFER, 16 * 1024);
+
+    // vertices, texture coords, colors
+    CALL_GL(glEnableVertexAttribArray(0));
+    CALL_GL(glEnableVertexAttribArray(1));
+    CALL_GL(glEnableVertexAttribArray(2));
+
+    currentMode = GL_TRIANGLES;
+    currentTexture = 0;
+    shapeStart = 0;
+
+    submissionCount[0] = 0;
+    submissionCount[1] = 0;
+    recordingSet = 0;
 
     currentColor = Vec4(1.0f, 1.0f, 1.0f, 1.0f);
     setLineWidth(1.0f);
 }
 
 RenderLayer::~RenderLayer() {
+    syncRenderThread();
     if (initialized) {
         defaultBatchShader.release();
+        defaultArrayBatchShader.release();
+        defaultPackedBatchShader.release();
+        defaultArrayPackedBatchShader.release();
         defaultShader.release();
 
         initialized = false;
@@ -149,14 +149,16 @@ RenderLayer::~RenderLayer() {
     glDeleteBuffers(1, &batchVAO);
     glDeleteBuffers(1, &batchEBO);
     glDeleteBuffers(1, &batchVBO);
-    glDeleteBuffers(1, &batchIBO);
+    instanceBuffer.release();
 
     glDeleteBuffers(1, &VAO);
-    glDeleteBuffers(1, &VBO);
+    immediateVertexBuffer.release();
+    immediateIndexBuffer.release();
 }
 
 void RenderLayer::setLineWidth(f32 width) {
-    CALL_GL(glLineWidth(width));
+    //    recorded into the draw runs, set on the GL side when they're drawn
+    lineWidth = width;
     halfWidth = width / 2.0f;
 }
 
@@ -164,176 +166,506 @@ void RenderLayer::renderQuad(const Quad& quad) {
     quadBatch.emplace_back(quad);
 }
 
-void RenderLayer::flush(i32 begin, i32 end) {
-    //  massive sinkhole on chemical road
-    CALL_GL(glBufferSubData(GL_ARRAY_BUFFER, 0, (end - begin + 1) * sizeof(Quad), &quadBatch[begin]));
-    CALL_GL(glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, end - begin + 1));
+void RenderLayer::renderQuads(const Quad* quads, u32 count, Vec3 offset, Vec4 color) {
+    size_t start = quadBatch.size();
+    quadBatch.insert(quadBatch.end(), quads, quads + count);
+
+    for (size_t i = start; i < quadBatch.size(); i++) {
+        Quad& quad = quadBatch[i];
+        quad.pos.x += offset.x;
+        quad.pos.y += offset.y;
+        quad.pos.z += offset.z;
+        quad.color = color;
+    }
+}
+
+//  instanced draws can't start partway into a buffer before GL 4.2, so the attribute
+//  pointers are moved to wherever this chunk was streamed to
+void RenderLayer::setInstanceAttributes(size_t offset) {
+    if (packedInstances) {
+        //        position
+        CALL_GL(glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(PackedQuad), (void*)offset));
+
+        //        size, already scaled. the packed shaders don't read attribute 3
+        CALL_GL(glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedQuad), (void*)(offset + offsetof(PackedQuad, size))));
+        CALL_GL(glVertexAttribPointer(3, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedQuad), (void*)(offset + offsetof(PackedQuad, size))));
+
+        //        rotation
+        CALL_GL(glVertexAttribPointer(4, 1, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(PackedQuad), (void*)(offset + offsetof(PackedQuad, rotation))));
+
+        //        uv
+        CALL_GL(glVertexAttribPointer(5, 4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedQuad), (void*)(offset + offsetof(PackedQuad, uv))));
+
+        //        texture unit
+        CALL_GL(glVertexAttribIPointer(6, 1, GL_SHORT, sizeof(PackedQuad), (void*)(offset + offsetof(PackedQuad, textureID))));
+
+        //        color
+        CALL_GL(glVertexAttribPointer(7, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PackedQuad), (void*)(offset + offsetof(PackedQuad, color))));
+
+        return;
+    }
+
+    //        position
+    CALL_GL(glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Quad), (void*)offset));
+
+    //        size
+    CALL_GL(glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Quad), (void*)(offset + sizeof(GLfloat) * 3)));
+
+    //        scale
+    CALL_GL(glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Quad), (void*)(offset + sizeof(GLfloat) * 5)));
+
+    //        rotation
+    CALL_GL(glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(Quad), (void*)(offset + sizeof(GLfloat) * 7)));
+
+    //        uv
+    CALL_GL(glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(Quad), (void*)(offset + sizeof(GLfloat) * 8)));
+
+    //        texture unit
+    CALL_GL(glVertexAttribIPointer(6, 1, GL_INT, sizeof(Quad), (void*)(offset + sizeof(GLfloat) * 12)));
+
+    //        color
+    CALL_GL(glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(Quad), (void*)(offset + sizeof(GLfloat) * 12 + sizeof(GLint))));
+}
+
+void RenderLayer::packQuads(const std::vector<Quad>& quads, i32 first, i32 count) {
+    packedBatch.resize(count);
+
+    for (i32 i = 0; i < count; i++) {
+        const Quad &quad = quads[first + i];
+        PackedQuad &packed = packedBatch[i];
+
+        packed.pos = quad.pos;
+        packed.size[0] = floatToHalf(quad.size.x * quad.scale.x);
+        packed.size[1] = floatToHalf(quad.size.y * quad.scale.y);
+        packed.rotation = packAngle(quad.rotation);
+        packed.textureID = (i16)quad.textureID;
+        packed.uv[0] = packUnorm16(quad.uv.x);
+        packed.uv[1] = packUnorm16(quad.uv.y);
+        packed.uv[2] = packUnorm16(quad.uv.z);
+        packed.uv[3] = packUnorm16(quad.uv.w);
+        packed.color[0] = packUnorm8(quad.color.r);
+        packed.color[1] = packUnorm8(quad.color.g);
+        packed.color[2] = packUnorm8(quad.color.b);
+        packed.color[3] = packUnorm8(quad.color.a);
+    }
+}
+
+void RenderLayer::flush(std::vector<Quad>& quads, i32 begin, i32 end) {
+    //    reach max batch size, flush em
+    for (i32 first = begin; first <= end; first += MAX_QUADS_PER_BATCH) {
+        i32 count = min(end - first + 1, MAX_QUADS_PER_BATCH);
+
+        size_t offset;
+        if (packedInstances) {
+            packQuads(quads, first, count);
+            offset = instanceBuffer.upload(&packedBatch[0], count * sizeof(PackedQuad), sizeof(PackedQuad));
+        } else {
+            offset = instanceBuffer.upload(&quads[first], count * sizeof(Quad), sizeof(Quad));
+        }
+        setInstanceAttributes(offset);
+
+        CALL_GL(glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, count));
+        renderState.stats.drawCalls++;
+    }
     textureCache.advanceFrame();
 }
 
-void RenderLayer::renderBatch(const Camera& camera) {
+void RenderLayer::useBatchShader(Shader *shader, const Camera& camera) {
     //    set transformation uniforms
-    batchShader->bind();
-    batchShader->setMat4("projection", camera.projectionMatrix);
+    shader->bind();
+    shader->setMat4(shader->projection, camera.projectionMatrix);
 
-    //    it renders
+    // set colorTransform uniform
+    shader->setMat4(shader->colorTransform, colorTransform);
+}
 
-    // enable VAO
-    CALL_GL(glBindVertexArray(batchVAO));
+void RenderLayer::sortBatch(std::vector<Quad>& quads) {
+    u32 count = quads.size();
+    if (!sorting || count < 2) {
+        return;
+    }
 
-    CALL_GL(glBindBuffer(GL_ARRAY_BUFFER, batchIBO));
+    sortKeys.resize(count);
+    for (u32 i = 0; i < count; i++) {
+        const Quad &quad = quads[i];
 
-    //    TODO: don't bind shaders redundantly!
-    batchShader->bind();
+        u64 key = (u32)quad.textureID;
+        if (depthSorting) {
+            key |= (u64)floatToSortable(quad.pos.z) << 32;
+        }
 
-    // set colorTransform uniform
-    batchShader->setMat4("colorTransform", colorTransform);
+        sortKeys[i].key = key;
+        sortKeys[i].index = i;
+    }
+
+    radixSort(sortKeys, sortScratch);
 
-    // sort quadBatch
-    std::stable_sort(quadBatch.begin(), quadBatch.end(), depthSorting ? cmpDepth : cmp);
+    sortedBatch.resize(count);
+    for (u32 i = 0; i < count; i++) {
+        sortedBatch[i] = quads[sortKeys[i].index];
+    }
+    quads.swap(sortedBatch);
+}
 
-    //    iterate renderbatch, set textureID to texture unit for each Quad before populating batchIBO
+void RenderLayer::cullBatch(const Camera& camera, std::vector<Quad>& quads) {
+    if (!culling || quads.empty()) {
+        return;
+    }
+
+    //    only cull when x and y map straight to clip space, like OrthographicCamera does. the
+    //    viewport covers whatever's bound, so this is the canvas bounds when drawing to one
+    const Mat4& p = camera.projectionMatrix;
+    if (p.data2d[1][0] != 0.0f || p.data2d[2][0] != 0.0f || p.data2d[0][1] != 0.0f || p.data2d[2][1] != 0.0f ||
+        p.data2d[0][3] != 0.0f || p.data2d[1][3] != 0.0f || p.data2d[2][3] != 0.0f || p.data2d[3][3] != 1.0f) {
+        return;
+    }
+    f32 scaleX = p.data2d[0][0];
+    f32 scaleY = p.data2d[1][1];
+    f32 offsetX = p.data2d[3][0];
+    f32 offsetY = p.data2d[3][1];
+    f32 extentX = fabsf(scaleX);
+    f32 extentY = fabsf(scaleY);
+
+    //    rotation can turn a quad any which way, so test its bounding circle
+    u32 kept = 0;
+    u32 count = quads.size();
+    for (u32 i = 0; i < count; i++) {
+        const Quad &quad = quads[i];
+
+        f32 width = quad.size.x * quad.scale.x;
+        f32 height = quad.size.y * quad.scale.y;
+        f32 radius = 0.5f * sqrtf(width * width + height * height);
+
+        f32 x = scaleX * quad.pos.x + offsetX;
+        f32 y = scaleY * quad.pos.y + offsetY;
+
+        if (fabsf(x) - extentX * radius > 1.0f || fabsf(y) - extentY * radius > 1.0f) {
+            continue;
+        }
+        if (kept != i) {
+            quads[kept] = quad;
+        }
+        kept++;
+    }
+
+    renderState.stats.culledQuads += count - kept;
+    quads.resize(kept);
+}
+
+void RenderLayer::renderBatch(const Camera& camera, std::vector<Quad>& quads) {
+    //    it renders
+
+    // enable VAO
+    renderState.bindVertexArray(batchVAO);
+
+    // cull and sort quadBatch
+    cullBatch(camera, quads);
+    sortBatch(quads);
+
+    //    the sort leaves quads sharing a texture next to each other, so the texture unit is resolved
+    //    once per run and written over each quad's textureID before the batch goes up. quads in
+    //    texture arrays carry (unit | layer << 4) instead, or -1 for untextured
+    Shader *currentShader = nullptr;
     i32 begin = 0;
-    i32 end = -1;
+    i32 count = quads.size();
 
-    for (u64 i = 0; i < quadBatch.size();) {
-        //    need pointer
-        Quad &quad = quadBatch[i];
+    for (i32 runStart = 0; runStart < count;) {
+        GLint textureID = quads[runStart].textureID;
+        i32 runEnd = runStart + 1;
+        while (runEnd < count && quads[runEnd].textureID == textureID) {
+            runEnd++;
+        }
+
+        if (textureID == 0) {
+            textureID = whiteTexture;
+        }
 
-        if (quad.textureID == 0) {
-            quad.textureID = whiteTexture;
+        GLuint arrayHandle = 0;
+        i32 layer = -1;
+        b8 arrayRun = false;
+        if (textureArrays) {
+            arrayRun = ((GLuint)textureID == whiteTexture) || findTextureArray(textureID, arrayHandle, layer);
         }
-        i32 ret = textureCache.bindTexture(quad.textureID);
 
-        if (ret == -1) {
-            //    no texture slots available. render and loop again without advancing index.
-            //  TODO: test this
-            flush(begin, end);
-            begin = end + 1;
+        //    switching between array and 2D pages means switching shaders
+        Shader *runShader;
+        if (arrayRun) {
+            runShader = packedInstances ? &defaultArrayPackedBatchShader : &defaultArrayBatchShader;
         } else {
-            quad.textureID = ret;
-            end++;
-
-            //    reach max batch size, flush em
-            if ((end - begin + 1) >= MAX_QUADS_PER_BATCH) {
-                flush(begin, end);
-                begin = end + 1;
-                end = begin - 1;
+            runShader = (packedInstances && batchShader == &defaultBatchShader) ? &defaultPackedBatchShader : batchShader;
+        }
+        if (runShader != currentShader) {
+            if (runStart > begin) {
+                flush(quads, begin, runStart - 1);
+                begin = runStart;
+            }
+            useBatchShader(runShader, camera);
+            currentShader = runShader;
+        }
+
+        GLint unit = -1;
+        if (!arrayRun || layer != -1) {
+            GLuint handle = arrayRun ? arrayHandle : textureID;
+            GLenum target = arrayRun ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+
+            unit = textureCache.bindTexture(handle, false, target);
+            if (unit == -1 && runStart > begin) {
+                //    no texture slots available. render what we have and try again
+                flush(quads, begin, runStart - 1);
+                begin = runStart;
+                unit = textureCache.bindTexture(handle, false, target);
             }
-            i++;
         }
+
+        GLint value = (arrayRun && unit != -1) ? (unit | (layer << 4)) : unit;
+        for (i32 i = runStart; i < runEnd; i++) {
+            quads[i].textureID = value;
+        }
+
+        runStart = runEnd;
     }
 
-    if (end >= begin) {
-        flush(begin, end);
+    if (count > begin) {
+        flush(quads, begin, count - 1);
     }
 
     //  this here open ballet is for errrone
-    quadBatch.clear();
-
-    // disable VAO and IBO
-    CALL_GL(glBindVertexArray(0));
-    CALL_GL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    quads.clear();
 }
 
 void RenderLayer::render(const Camera& camera) {
-    renderBatch(camera);
+    syncRenderThread();
+
+    //    draw straight from what's been recorded
+    Submission current;
+    swapSubmission(current);
+    renderSubmission(camera, current);
+    swapSubmission(current);
+}
+
+void RenderLayer::renderSubmission(const Camera& camera, Submission& submission) {
+    renderBatch(camera, submission.quadBatch);
+
+    if (!submission.drawRuns.empty()) {
+        renderImmediate(camera, submission);
+    }
+
+    textureCache.advanceFrame();
+}
+
+void RenderLayer::endFrame() {
+    instanceBuffer.advanceFrame();
+    immediateVertexBuffer.advanceFrame();
+    immediateIndexBuffer.advanceFrame();
+}
+
+u32 RenderLayer::submit() {
+    std::vector<Submission>& set = submissions[recordingSet];
+    u32& count = submissionCount[recordingSet];
+
+    if (count == set.size()) {
+        set.emplace_back();
+    }
+    swapSubmission(set[count]);
+
+    return count++;
+}
+
+void RenderLayer::flip() {
+    recordingSet ^= 1;
+    submissionCount[recordingSet] = 0;
+}
+
+void RenderLayer::render(const Camera& camera, u32 submission) {
+    renderSubmission(camera, submissions[recordingSet ^ 1][submission]);
+}
+
+void RenderLayer::swapSubmission(Submission& submission) {
+    quadBatch.swap(submission.quadBatch);
+    vertices.swap(submission.vertices);
+    indices.swap(submission.indices);
+    drawRuns.swap(submission.drawRuns);
+}
+
+void RenderLayer::renderImmediate(const Camera& camera, Submission& submission) {
+    std::vector<GLfloat>& vertices = submission.vertices;
+    std::vector<GLuint>& indices = submission.indices;
+    std::vector<DrawRun>& drawRuns = submission.drawRuns;
 
     //    set transformation uniforms
     shader->bind();
-    shader->setMat4("projection", camera.projectionMatrix);
+    shader->setMat4(shader->projection, camera.projectionMatrix);
 
     // set colorTransform uniform
-    shader->setMat4("colorTransform", colorTransform);
+    shader->setMat4(shader->colorTransform, colorTransform);
 
-    CALL_GL(glBindVertexArray(VAO));
+    renderState.bindVertexArray(VAO);
 
-    for (auto renderItem : renderItems) {
-        // bind texture
-        u32 slot = textureCache.bindTexture(renderItem.texture);
-        shader->setInt("Texture", slot);
+    //    the whole frame's worth of shapes goes up in one go
+    const GLsizei stride = 9 * sizeof(GLfloat);
+    size_t vertexOffset = immediateVertexBuffer.upload(&vertices[0], sizeof(GLfloat) * vertices.size(), stride);
+
+    // vertices
+    CALL_GL(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)vertexOffset));
+
+    // texture coords
+    CALL_GL(glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(vertexOffset + 3 * sizeof(GLfloat))));
 
-        CALL_GL(glBindBuffer(GL_ARRAY_BUFFER, VBO));
-        CALL_GL(glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * renderItem.vertices.size(), &renderItem.vertices[0], GL_DYNAMIC_DRAW));
+    // colors
+    CALL_GL(glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(vertexOffset + 5 * sizeof(GLfloat))));
 
-        // vertices
-        CALL_GL(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(GLfloat), (GLvoid*)0));
-        CALL_GL(glEnableVertexAttribArray(0));
+    size_t indexOffset = immediateIndexBuffer.upload(&indices[0], sizeof(GLuint) * indices.size());
 
-        // texture coords
-        CALL_GL(glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 9 * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat))));
-        CALL_GL(glEnableVertexAttribArray(1));
+    GLuint boundTexture = 0;
+    f32 boundLineWidth = 0.0f;
+    for (u32 i = 0; i < drawRuns.size(); i++) {
+        const DrawRun& run = drawRuns[i];
+
+        //    line width is GL state, so it's set as each line run comes up rather than when
+        //    the script asked for it
+        if (run.mode == GL_LINES && run.lineWidth != boundLineWidth) {
+            CALL_GL(glLineWidth(run.lineWidth));
+            boundLineWidth = run.lineWidth;
+        }
 
-        // colors
-        CALL_GL(glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, 9 * sizeof(GLfloat), (GLvoid*)(5 * sizeof(GLfloat))));
-        CALL_GL(glEnableVertexAttribArray(2));
+        // bind texture
+        if (i == 0 || run.texture != boundTexture) {
+            i32 slot = textureCache.bindTexture(run.texture);
+            if (slot == -1) {
+                textureCache.advanceFrame();
+                slot = textureCache.bindTexture(run.texture);
+            }
+            shader->setInt(shader->texture, slot);
+            boundTexture = run.texture;
+        }
 
         // render!
-        CALL_GL(glDrawArrays(renderItem.mode, 0, renderItem.vertices.size() / 9));
+        CALL_GL(glDrawElements(run.mode, run.indexCount, GL_UNSIGNED_INT, (GLvoid*)(indexOffset + run.firstIndex * sizeof(GLuint))));
+        renderState.stats.drawCalls++;
     }
 
-    CALL_GL(glBindVertexArray(0));
-
-    renderItems.clear();
-    textureCache.advanceFrame();
+    vertices.clear();
+    indices.clear();
+    drawRuns.clear();
 }
 
 void RenderLayer::begin(GLenum mode, GLuint texture) {
-    currentRenderItem.vertices.clear();
-    currentRenderItem.mode = mode;
-    currentRenderItem.texture = texture;
+    currentMode = mode;
+    currentTexture = texture;
+    shapeStart = vertices.size() / 9;
+}
+
+void RenderLayer::pushVertex(f32 x, f32 y, f32 z, f32 u, f32 v, f32 r, f32 g, f32 b, f32 a) {
+    size_t i = vertices.size();
+    vertices.resize(i + 9);
+
+    GLfloat *vertex = &vertices[i];
+    vertex[0] = x;
+    vertex[1] = y;
+    vertex[2] = z;
+    vertex[3] = u;
+    vertex[4] = v;
+    vertex[5] = r;
+    vertex[6] = g;
+    vertex[7] = b;
+    vertex[8] = a;
 }
 
 void RenderLayer::addVertex(f32 x, f32 y, f32 z) {
-    currentRenderItem.vertices.emplace_back(x);
-    currentRenderItem.vertices.emplace_back(y);
-    currentRenderItem.vertices.emplace_back(z);
-    currentRenderItem.vertices.emplace_back(0.0f); // u
-    currentRenderItem.vertices.emplace_back(0.0f); // v
-    currentRenderItem.vertices.emplace_back(currentColor.r);
-    currentRenderItem.vertices.emplace_back(currentColor.g);
-    currentRenderItem.vertices.emplace_back(currentColor.b);
-    currentRenderItem.vertices.emplace_back(currentColor.a);
+    pushVertex(x, y, z, 0.0f, 0.0f, currentColor.r, currentColor.g, currentColor.b, currentColor.a);
 }
 
 void RenderLayer::addVertex(f32 x, f32 y, f32 u, f32 v) {
-    currentRenderItem.vertices.emplace_back(x);
-    currentRenderItem.vertices.emplace_back(y);
-    currentRenderItem.vertices.emplace_back(-1);
-    currentRenderItem.vertices.emplace_back(u);
-    currentRenderItem.vertices.emplace_back(v);
-    currentRenderItem.vertices.emplace_back(currentColor.r);
-    currentRenderItem.vertices.emplace_back(currentColor.g);
-    currentRenderItem.vertices.emplace_back(currentColor.b);
-    currentRenderItem.vertices.emplace_back(currentColor.a);
+    pushVertex(x, y, -1, u, v, currentColor.r, currentColor.g, currentColor.b, currentColor.a);
 }
 
 void RenderLayer::addVertex(f32 x, f32 y, f32 r, f32 g, f32 b, f32 a) {
-    currentRenderItem.vertices.emplace_back(x);
-    currentRenderItem.vertices.emplace_back(y);
-    currentRenderItem.vertices.emplace_back(-1);
-    currentRenderItem.vertices.emplace_back(0.0f); // u
-    currentRenderItem.vertices.emplace_back(0.0f); // v
-    currentRenderItem.vertices.emplace_back(r);
-    currentRenderItem.vertices.emplace_back(g);
-    currentRenderItem.vertices.emplace_back(b);
-    currentRenderItem.vertices.emplace_back(a);
+    pushVertex(x, y, -1, 0.0f, 0.0f, r, g, b, a);
 }
 
 void RenderLayer::addVertex(f32 x, f32 y, f32 u, f32 v, f32 r, f32 g, f32 b, f32 a) {
-    currentRenderItem.vertices.emplace_back(x);
-    currentRenderItem.vertices.emplace_back(y);
-    currentRenderItem.vertices.emplace_back(-1);
-    currentRenderItem.vertices.emplace_back(u);
-    currentRenderItem.vertices.emplace_back(v);
-    currentRenderItem.vertices.emplace_back(r);
-    currentRenderItem.vertices.emplace_back(g);
-    currentRenderItem.vertices.emplace_back(b);
-    currentRenderItem.vertices.emplace_back(a);
+    pushVertex(x, y, -1, u, v, r, g, b, a);
 }
 
+//    fans, strips and loops are turned into plain indexed lists so that consecutive
+//    shapes can share a draw call
 void RenderLayer::end() {
-    renderItems.emplace_back(currentRenderItem);
+    GLuint first = shapeStart;
+    GLuint count = vertices.size() / 9 - shapeStart;
+    u32 firstIndex = indices.size();
+    GLenum mode;
+
+    switch (currentMode) {
+        case GL_TRIANGLES:
+            mode = GL_TRIANGLES;
+            for (GLuint i = 0; i + 2 < count; i += 3) {
+                indices.insert(indices.end(), {first + i, first + i + 1, first + i + 2});
+            }
+            break;
+
+        case GL_TRIANGLE_FAN:
+            mode = GL_TRIANGLES;
+            for (GLuint i = 1; i + 1 < count; i++) {
+                indices.insert(indices.end(), {first, first + i, first + i + 1});
+            }
+            break;
+
+        case GL_TRIANGLE_STRIP:
+            //    flip every other triangle to keep the winding consistent
+            mode = GL_TRIANGLES;
+            for (GLuint i = 0; i + 2 < count; i++) {
+                if (i % 2 == 0) {
+                    indices.insert(indices.end(), {first + i, first + i + 1, first + i + 2});
+                } else {
+                    indices.insert(indices.end(), {first + i + 1, first + i, first + i + 2});
+                }
+            }
+            break;
+
+        case GL_LINES:
+            mode = GL_LINES;
+            for (GLuint i = 0; i + 1 < count; i += 2) {
+                indices.insert(indices.end(), {first + i, first + i + 1});
+            }
+            break;
+
+        case GL_LINE_STRIP:
+        case GL_LINE_LOOP:
+            mode = GL_LINES;
+            for (GLuint i = 0; i + 1 < count; i++) {
+                indices.insert(indices.end(), {first + i, first + i + 1});
+            }
+            if (currentMode == GL_LINE_LOOP && count > 2) {
+                indices.insert(indices.end(), {first + count - 1, first});
+            }
+            break;
+
+        default:
+            mode = GL_POINTS;
+            for (GLuint i = 0; i < count; i++) {
+                indices.push_back(first + i);
+            }
+            break;
+    }
+
+    u32 indexCount = indices.size() - firstIndex;
+    if (indexCount == 0) {
+        return;
+    }
+
+    //    extend the last run if nothing about the draw state has changed
+    if (!drawRuns.empty() && drawRuns.back().mode == mode && drawRuns.back().texture == currentTexture &&
+            (mode != GL_LINES || drawRuns.back().lineWidth == lineWidth)) {
+        drawRuns.back().indexCount += indexCount;
+    } else {
+        DrawRun run;
+        run.mode = mode;
+        run.texture = currentTexture;
+        run.lineWidth = lineWidth;
+        run.firstIndex = firstIndex;
+        run.indexCount = indexCount;
+        drawRuns.push_back(run);
+    }
 }
 
 void RenderLayer::renderTri(f32 x1, f32 y1, f32 x2, f32 y2, f32 x3, f32 y3, bool full) {
@@ -452,4 +784,25 @@ void RenderLayer::renderLines(f32 endpoints[], i32 lineCount) {
     end();
 }
 
+size_t RenderLayer::getReservedBytes() const {
+    size_t bytes = (quadBatch.capacity() + sortedBatch.capacity()) * sizeof(Quad);
+    bytes += (sortKeys.capacity() + sortScratch.capacity()) * sizeof(SortKey);
+    bytes += packedBatch.capacity() * sizeof(PackedQuad);
+
+    bytes += vertices.capacity() * sizeof(GLfloat);
+    bytes += indices.capacity() * sizeof(GLuint);
+    bytes += drawRuns.capacity() * sizeof(DrawRun);
+
+    for (u32 set = 0; set < 2; set++) {
+        for (auto& submission : submissions[set]) {
+            bytes += submission.quadBatch.capacity() * sizeof(Quad);
+            bytes += submission.vertices.capacity() * sizeof(GLfloat);
+            bytes += submission.indices.capacity() * sizeof(GLuint);
+            bytes += submission.drawRuns.capacity() * sizeof(DrawRun);
+        }
+    }
+
+    return bytes;
+}
+
 }
@@ -28,6 +28,9 @@ freely, subject to the following restrictions:
 #include "camera.h"
 #include "shader.h"
 #include "textureCache.h"
+#include "streamBuffer.h"
+#include "../misc/radixSort.h"
+#include "../misc/packing.h"
 
 namespace AB {
 
@@ -47,11 +50,39 @@ class RenderLayer {
             Vec4 color;        
         };
 
-        RenderLayer(Shader *batchShader = &defaultBatchShader, Shader *shader = &defaultShader, Mat4 colorTransform = Mat4(), bool depthSorting = false);
+        //    what a Quad is squeezed into on layers with packed instances. size is pre-multiplied
+        //    by scale, and uvs are clamped to [0, 1]
+        struct PackedQuad {
+            Vec3 pos;
+            u16 size[2];        // half floats
+            u16 rotation;       // 1/65536ths of a turn
+            i16 textureID;      // resolved texture unit
+            u16 uv[4];          // unorm16
+            u8 color[4];        // unorm8, premultiplied like everything else
+        };
+
+        RenderLayer(Shader *batchShader = &defaultBatchShader, Shader *shader = &defaultShader, Mat4 colorTransform = Mat4(), bool depthSorting = false, bool textureArrays = false, bool packedInstances = false);
         virtual ~RenderLayer();
         
         virtual void render(const Camera& camera);
 
+        //    hands everything recorded so far over to the render queue and starts recording afresh.
+        //    returns the handle to render it with
+        virtual u32 submit();
+
+        //    submissions are double buffered. after a flip the ones submitted so far are the ones
+        //    render() draws, and new submissions go to the other set, so one frame can be drawn
+        //    on the render thread while the next is recorded
+        void flip();
+        virtual void render(const Camera& camera, u32 submission);
+
+        //    called once the whole frame has been drawn, however many times the layer was. moves
+        //    the stream buffers on to their next region, so a region is only reused a full
+        //    frame later
+        void endFrame();
+
+        virtual bool isEmpty() const { return quadBatch.empty() && drawRuns.empty(); }
+
         //    state
         void setLineWidth(float width);
         void setColor(Vec4 color) { currentColor = color; }
@@ -67,6 +98,9 @@ class RenderLayer {
 
         //    submits a quad to the batch renderer
         void renderQuad(const Quad& quad);
+
+        //    submits prebuilt quads in one go, moved by offset and recolored. for text and tile maps
+        void renderQuads(const Quad* quads, u32 count, Vec3 offset, Vec4 color);
         
         //    these are queued and render after the quad batch
         void renderTri(float x1, float y1, float x2, float y2, float x3, float y3, bool full = true);
@@ -75,16 +109,39 @@ class RenderLayer {
         void renderArc(float x, float y, float radius, float angle1, float angle2, int segments = 10);
         void renderRoundedRectangle(float x, float y, float w, float h, float radius, bool full = true, int segments = 8);
         void renderLines(float endpoints[], int lineCount); // {x1, y1, x2, y2, ...}
+
+        //    bytes held by the quad batch and immediate mode queues, for leak tracking
+        virtual size_t getReservedBytes() const;
         
         std::vector<Quad> quadBatch;
         Shader *batchShader;
         Shader *shader;
 
         bool depthSorting;        //    only applies to batch renderer
+
+        //    draw textures that were built into texture arrays with the array batch shader. a run
+        //    of quads then only needs a texture unit per array rather than per page
+        bool textureArrays;
+
+        //    upload 32 byte PackedQuads instead of Quads, drawn with the packed shader variants.
+        //    worth it for sprite heavy layers that don't need precise scales or tiling uvs
+        bool packedInstances;
+
+        //    drop quads whose bounding circle is outside the view before sorting and upload. only
+        //    happens for 2D (orthographic) cameras. turn it off for layers with custom batch shaders
+        //    that move quads around
+        bool culling = true;
+
+        //    sort the batch by texture (and depth) before upload. turn it off for layers whose quads
+        //    already arrive in draw order, like a particle system's, so they aren't sorted twice
+        bool sorting = true;
         
         Mat4 colorTransform;
 
         static Shader defaultBatchShader;
+        static Shader defaultArrayBatchShader;
+        static Shader defaultPackedBatchShader;
+        static Shader defaultArrayPackedBatchShader;
         static Shader defaultShader;
 
         static TextureCache textureCache;
@@ -95,43 +152,70 @@ class RenderLayer {
         static GLuint quadElements[];
 
     protected:
-        //    for std::sort
-        static inline bool cmp(const Quad& a, const Quad& b) {
-            return a.textureID < b.textureID;
-        }
-
-        static inline bool cmpDepth(const Quad& a, const Quad& b) {
-            if (a.pos.z == b.pos.z) {
-                return a.textureID < b.textureID;
-            } else {
-                return a.pos.z < b.pos.z;
-            }
-        }
-        
-        void flush(int begin, int end);
-        void renderBatch(const Camera& camera);
-
-        //    non-batch rendering stuff
-        struct RenderItem {
-            std::vector<GLfloat> vertices;   // x, y, z, u, v, r, g, b, a
-            GLenum mode;
+        void flush(std::vector<Quad>& quads, int begin, int end);
+        void useBatchShader(Shader *shader, const Camera& camera);
+        void setInstanceAttributes(size_t offset);
+        void sortBatch(std::vector<Quad>& quads);
+        void cullBatch(const Camera& camera, std::vector<Quad>& quads);
+        void renderBatch(const Camera& camera, std::vector<Quad>& quads);
+
+        //    radix sort working space, kept between frames
+        std::vector<SortKey> sortKeys;
+        std::vector<SortKey> sortScratch;
+        std::vector<Quad> sortedBatch;
+        std::vector<PackedQuad> packedBatch;
+
+        void packQuads(const std::vector<Quad>& quads, i32 first, i32 count);
+
+        //    non-batch rendering stuff. shapes are gathered into one vertex and index stream
+        //    per frame, with consecutive shapes sharing a texture and primitive type drawn together
+        struct DrawRun {
+            GLenum mode;        //    GL_TRIANGLES, GL_LINES or GL_POINTS
             GLuint texture;
+            f32 lineWidth;      //    only matters to GL_LINES runs
+            u32 firstIndex;
+            u32 indexCount;
+        };
+        std::vector<GLfloat> vertices;   // x, y, z, u, v, r, g, b, a
+        std::vector<GLuint> indices;
+        std::vector<DrawRun> drawRuns;
+
+        GLenum currentMode;
+        GLuint currentTexture;
+        u32 shapeStart;
+
+        //    recordings waiting in the render queue. storage is swapped in and out so
+        //    capacity gets reused from frame to frame
+        struct Submission {
+            std::vector<Quad> quadBatch;
+            std::vector<GLfloat> vertices;
+            std::vector<GLuint> indices;
+            std::vector<DrawRun> drawRuns;
         };
-        std::vector<RenderItem> renderItems;
-        RenderItem currentRenderItem;
+        std::vector<Submission> submissions[2];
+        u32 submissionCount[2];
+        u32 recordingSet;
+
+        void swapSubmission(Submission& submission);
+        void renderSubmission(const Camera& camera, Submission& submission);
+
+        void pushVertex(f32 x, f32 y, f32 z, f32 u, f32 v, f32 r, f32 g, f32 b, f32 a);
+        void renderImmediate(const Camera& camera, Submission& submission);
 
         /// what about all this stuff?/
         //  TODO: move these into render state in renderer.h
         Vec4 currentColor;
+        float lineWidth;
         float halfWidth;
 
         GLuint batchVAO;        //    vertex array object
         GLuint batchVBO;        //    vertex buffer
         GLuint batchEBO;        //    element buffer
-        GLuint batchIBO;        //    per-instance vertex buffer
+        StreamBuffer instanceBuffer;    //    per-instance vertex buffer
 
         GLuint VAO;        //    vertex array object
-        GLuint VBO;        //    vertex buffer
+        StreamBuffer immediateVertexBuffer;
+        StreamBuffer immediateIndexBuffer;
 
 };
 
@@ -0,0 +1,176 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#include "../pch.h"
+
+#include "renderQueue.h"
+#include "renderLayer.h"
+#include "renderTarget.h"
+#include "renderState.h"
+#include "../core/log.h"
+#include "../core/window.h"
+
+namespace AB {
+
+extern Window window;
+
+//  sort key, high bits to low: pass (16) | command type (8) | order within type (32)
+static u64 makeKey(u32 pass, u8 type, u32 order) {
+    return ((u64)(pass & 0xFFFF) << 40) | ((u64)type << 32) | order;
+}
+
+RenderQueue::RenderQueue() {
+    pass = 0;
+    currentTarget = 0;
+    boundTarget = NO_TARGET;
+}
+
+void RenderQueue::push(const RenderCommand& command, u32 order) {
+    //  the first pass of a frame draws wherever the last frame left off
+    if (commands.empty() && command.type != RenderCommand::TARGET) {
+        RenderCommand target;
+        target.type = RenderCommand::TARGET;
+        target.canvas = currentTarget;
+        push(target, 0);
+    }
+
+    SortKey key;
+    key.key = makeKey(pass, command.type, order);
+    key.index = commands.size();
+
+    sortKeys.push_back(key);
+    commands.push_back(command);
+}
+
+void RenderQueue::setTarget(u32 canvas) {
+    if (canvas == currentTarget) {
+        return;
+    }
+    pass++;
+    currentTarget = canvas;
+
+    RenderCommand command;
+    command.type = RenderCommand::TARGET;
+    command.canvas = canvas;
+    push(command, 0);
+}
+
+void RenderQueue::clear(f32 r, f32 g, f32 b, f32 a) {
+    RenderCommand command;
+    command.type = RenderCommand::CLEAR;
+    command.color[0] = r;
+    command.color[1] = g;
+    command.color[2] = b;
+    command.color[3] = a;
+    push(command, 0);
+}
+
+u32 RenderQueue::addCamera(const Camera& camera) {
+    cameras.push_back(camera);
+    return cameras.size() - 1;
+}
+
+void RenderQueue::drawLayer(u32 layerIndex, RenderLayer *layer, u32 submission, u32 camera) {
+    RenderCommand command;
+    command.type = RenderCommand::LAYER;
+    command.draw.layer = layer;
+    command.draw.submission = submission;
+    command.draw.camera = camera;
+
+    //    larger indices render first
+    push(command, 0xFFFFFFFF - layerIndex);
+}
+
+void RenderQueue::execute(std::map<u32, RenderTarget*>& canvases) {
+    radixSort(sortKeys, sortScratch);
+
+    //  something outside the queue may have bound things since last frame
+    renderState.invalidate();
+    boundTarget = NO_TARGET;
+
+    for (u32 i = 0; i < sortKeys.size(); i++) {
+        const RenderCommand& command = commands[sortKeys[i].index];
+
+        switch (command.type) {
+            case RenderCommand::TARGET:
+                if (command.canvas == boundTarget) {
+                    break;
+                }
+                if (command.canvas != 0) {
+                    RenderTarget *target = NULL;
+                    auto iterator = canvases.find(command.canvas);
+                    if (iterator != canvases.end()) {
+                        target = iterator->second;
+                    } else {
+                        for (auto& retired : retiredTargets) {
+                            if (retired.first == command.canvas) {
+                                target = retired.second;
+                            }
+                        }
+                    }
+                    if (!target) {
+                        ERR("Render target not created: %d", command.canvas);
+                        break;
+                    }
+                    target->begin();
+                } else {
+                    renderState.bindFramebuffer(0);
+                    window.resetViewport();
+                }
+                boundTarget = command.canvas;
+                break;
+
+            case RenderCommand::CLEAR:
+                CALL_GL(glClearColor(command.color[0], command.color[1], command.color[2], command.color[3]));
+                CALL_GL(glClear(GL_COLOR_BUFFER_BIT));
+                break;
+
+            case RenderCommand::LAYER:
+                command.draw.layer->render(cameras[command.draw.camera], command.draw.submission);
+                break;
+        }
+    }
+
+    renderState.bindVertexArray(0);
+
+    commands.clear();
+    sortKeys.clear();
+    cameras.clear();
+    pass = 0;
+
+    releaseRetired();
+}
+
+void RenderQueue::retireTarget(u32 canvas, RenderTarget *target) {
+    retiredTargets.push_back({ canvas, target });
+}
+
+void RenderQueue::releaseRetired() {
+    for (auto& retired : retiredTargets) {
+        delete retired.second;
+    }
+    retiredTargets.clear();
+}
+
+}   //  namespace
@@ -0,0 +1,106 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#ifndef AB_RENDER_QUEUE_H
+#define AB_RENDER_QUEUE_H
+
+#include "camera.h"
+#include "../misc/radixSort.h"
+
+namespace AB {
+
+class RenderLayer;
+class RenderTarget;
+
+//  A frame's worth of target switches, clears and layer draws. Nothing touches GL while
+//  recording; execute() sorts the commands once and plays them back in a single pass,
+//  leaving out binds that wouldn't change anything.
+//
+//  Every target switch starts a new pass. Within a pass the target is bound first, then
+//  clears, then layers from the highest index down, which is the order things came out in
+//  when layers were flushed on the spot.
+class RenderQueue {
+    public:
+        RenderQueue();
+
+        //  canvas index, 0 for the default framebuffer
+        void setTarget(u32 canvas);
+        void clear(f32 r, f32 g, f32 b, f32 a);
+
+        //  layers are submitted when a pass ends, all drawn with the camera of that moment
+        u32 addCamera(const Camera& camera);
+        void drawLayer(u32 layerIndex, RenderLayer *layer, u32 submission, u32 camera);
+
+        void execute(std::map<u32, RenderTarget*>& canvases);
+
+        //  for a canvas deleted while this frame may still draw to it. commands find it here
+        //  when it's gone from the canvas map, and it's deleted after the queue has run
+        void retireTarget(u32 canvas, RenderTarget *target);
+        void releaseRetired();
+
+        u32 getCommandCount() const { return commands.size(); }
+
+        //  the canvas draws are being recorded for, 0 for the default framebuffer
+        u32 getTarget() const { return currentTarget; }
+
+        //  picks up where another queue's recording left off, for double buffering
+        void continueFrom(const RenderQueue& previous) { currentTarget = previous.currentTarget; }
+
+    private:
+        struct RenderCommand {
+            enum Type : u8 {
+                TARGET,
+                CLEAR,
+                LAYER,
+            } type;
+
+            union {
+                u32 canvas;
+                f32 color[4];
+                struct {
+                    RenderLayer *layer;
+                    u32 submission;
+                    u32 camera;
+                } draw;
+            };
+        };
+
+        void push(const RenderCommand& command, u32 order);
+
+        std::vector<RenderCommand> commands;
+        std::vector<SortKey> sortKeys;
+        std::vector<SortKey> sortScratch;
+        std::vector<Camera> cameras;
+        std::vector<std::pair<u32, RenderTarget*>> retiredTargets;
+
+        static const u32 NO_TARGET = 0xFFFFFFFF;
+
+        u32 pass;
+        u32 currentTarget;      //  last target recorded, carried into the next frame
+        u32 boundTarget;        //  last target executed
+};
+
+}   //  namespace
+
+#endif
@@ -0,0 +1,98 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#include "../pch.h"
+
+#include "renderState.h"
+#include "../core/log.h"
+
+namespace AB {
+
+RenderState renderState;
+
+RenderState::RenderState() {
+    invalidate();
+
+    memset(&stats, 0, sizeof(stats));
+    memset(&lastFrame, 0, sizeof(lastFrame));
+}
+
+void RenderState::useProgram(GLuint program) {
+    if (programValid && this->program == program) {
+        stats.programSkips++;
+        return;
+    }
+    stats.programBinds++;
+    CALL_GL(glUseProgram(program));
+    this->program = program;
+    programValid = true;
+}
+
+void RenderState::bindVertexArray(GLuint vao) {
+    if (vaoValid && this->vao == vao) {
+        stats.vertexArraySkips++;
+        return;
+    }
+    stats.vertexArrayBinds++;
+    CALL_GL(glBindVertexArray(vao));
+    this->vao = vao;
+    vaoValid = true;
+}
+
+void RenderState::bindFramebuffer(GLuint fbo) {
+    if (fboValid && this->fbo == fbo) {
+        stats.framebufferSkips++;
+        return;
+    }
+    stats.framebufferBinds++;
+    CALL_GL(glBindFramebuffer(GL_FRAMEBUFFER, fbo));
+    this->fbo = fbo;
+    fboValid = true;
+}
+
+void RenderState::setBlendFunc(GLenum source, GLenum destination) {
+    if (blendValid && blendSource == source && blendDestination == destination) {
+        stats.blendSkips++;
+        return;
+    }
+    stats.blendChanges++;
+    CALL_GL(glBlendFunc(source, destination));
+    blendSource = source;
+    blendDestination = destination;
+    blendValid = true;
+}
+
+void RenderState::invalidate() {
+    programValid = false;
+    vaoValid = false;
+    fboValid = false;
+    blendValid = false;
+}
+
+void RenderState::endFrame() {
+    lastFrame = stats;
+    memset(&stats, 0, sizeof(stats));
+}
+
+}   //  namespace
@@ -0,0 +1,76 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#ifndef AB_RENDER_STATE_H
+#define AB_RENDER_STATE_H
+
+namespace AB {
+
+//  Shadows the GL binds that are expensive to repeat so the render queue can skip redundant
+//  program, vertex array, framebuffer and blend changes. Everything that binds these should
+//  go through here, otherwise call invalidate() afterwards.
+class RenderState {
+    public:
+        RenderState();
+
+        void useProgram(GLuint program);
+        void bindVertexArray(GLuint vao);
+        void bindFramebuffer(GLuint fbo);
+        void setBlendFunc(GLenum source, GLenum destination);
+
+        //  forget everything, the next call of each kind always reaches GL
+        void invalidate();
+
+        //  state churn, counted from the last endFrame(). skips are calls that matched the
+        //  shadowed state and never reached GL
+        struct Stats {
+            u32 programBinds, programSkips;
+            u32 vertexArrayBinds, vertexArraySkips;
+            u32 framebufferBinds, framebufferSkips;
+            u32 blendChanges, blendSkips;
+            u32 uniformUploads, uniformSkips;
+            u32 drawCalls;
+            u32 culledQuads;
+        } stats;
+
+        //  keeps the counts so far as the last frame's and starts counting again
+        void endFrame();
+        const Stats& getLastFrame() const { return lastFrame; }
+
+    private:
+        GLuint program;
+        GLuint vao;
+        GLuint fbo;
+        GLenum blendSource, blendDestination;
+
+        b8 programValid, vaoValid, fboValid, blendValid;
+
+        Stats lastFrame;
+};
+
+extern RenderState renderState;
+
+}   //  namespace
+
+#endif
@@ -26,6 +26,8 @@ freely, subject to the following restrictions:
 
 #include "renderTarget.h"
 #include "renderLayer.h"
+#include "renderState.h"
+#include "renderThread.h"
 #include "../core/log.h"
 #include "../core/window.h"
 
@@ -34,6 +36,7 @@ namespace AB {
 extern Window window;
 
 RenderTarget::RenderTarget(int width, int height, bool depthStencil) {
+    syncRenderThread();
     this->width = width;
     this->height = height;
     
@@ -92,7 +95,9 @@ RenderTarget::RenderTarget(int width, int height, bool depthStencil) {
 }
 
 RenderTarget::~RenderTarget() {
+    syncRenderThread();
     CALL_GL(glDeleteFramebuffers(1, &fbo));
+    renderState.invalidate();
     CALL_GL(glDeleteTextures(1, &texture));
 
     if (hasDepthStencil) {
@@ -101,6 +106,7 @@ RenderTarget::~RenderTarget() {
 }
 
 void RenderTarget::clear() {
+    syncRenderThread();
     CALL_GL(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
     if (hasDepthStencil) {
         CALL_GL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT));
@@ -111,12 +117,12 @@ void RenderTarget::clear() {
 
 void RenderTarget::begin() {
     RenderLayer::textureCache.evictTexture(texture);
-    CALL_GL(glBindFramebuffer(GL_FRAMEBUFFER, fbo));
+    renderState.bindFramebuffer(fbo);
     CALL_GL(glViewport(0, 0, width, height));
 }
 
 void RenderTarget::end() {
-    CALL_GL(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+    renderState.bindFramebuffer(0);
 
     //    TODO: need to reset viewport here but we don't know the dimensions.
     //          maybe the renderer or window class should
@@ -0,0 +1,154 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#include "../pch.h"
+
+#include "renderThread.h"
+#include "renderer.h"
+#include "../core/window.h"
+#include "../core/log.h"
+
+namespace AB {
+
+extern Renderer renderer;
+extern Window window;
+
+RenderThread renderThread;
+
+void RenderThread::start() {
+    if (running) {
+        return;
+    }
+    LOG("Starting render thread", 0);
+
+    frames = 0;
+    waitTicks = 0;
+    renderTicks = 0;
+
+    busy = false;
+    quit = false;
+    renderer.pipelined = true;
+
+    //  the context can only be current on one thread at a time
+    SDL_GL_MakeCurrent(window.window, NULL);
+    mainHasContext = false;
+
+    thread = std::thread(&RenderThread::threadMain, this);
+    running = true;
+}
+
+void RenderThread::stop() {
+    if (!running) {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return !busy; });
+        quit = true;
+    }
+    wake.notify_one();
+    thread.join();
+
+    running = false;
+    renderer.pipelined = false;
+
+    SDL_GL_MakeCurrent(window.window, window.glContext);
+    mainHasContext = true;
+
+    if (frames > 0) {
+        LOG("Render thread: %llu frames, %.3f ms render, %.3f ms main thread wait (average)",
+            (unsigned long long)frames,
+            renderTicks * 1000.0 / SDL_GetPerformanceFrequency() / frames,
+            waitTicks * 1000.0 / SDL_GetPerformanceFrequency() / frames);
+    }
+}
+
+void RenderThread::waitIdle() {
+    u64 start = SDL_GetPerformanceCounter();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return !busy; });
+
+    waitTicks += SDL_GetPerformanceCounter() - start;
+}
+
+void RenderThread::submitFrame() {
+    waitIdle();
+
+    if (mainHasContext) {
+        SDL_GL_MakeCurrent(window.window, NULL);
+        mainHasContext = false;
+    }
+
+    //  nothing is executing, so the recorded frame can change hands
+    renderer.flipFrame();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        busy = true;
+    }
+    wake.notify_one();
+}
+
+void RenderThread::sync() {
+    if (std::this_thread::get_id() == thread.get_id()) {
+        return;
+    }
+    waitIdle();
+
+    if (!mainHasContext) {
+        SDL_GL_MakeCurrent(window.window, window.glContext);
+        mainHasContext = true;
+    }
+}
+
+void RenderThread::threadMain() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return busy || quit; });
+            if (quit) {
+                return;
+            }
+        }
+
+        u64 start = SDL_GetPerformanceCounter();
+
+        SDL_GL_MakeCurrent(window.window, window.glContext);
+        renderer.executeFrame();
+        window.present();
+        SDL_GL_MakeCurrent(window.window, NULL);
+
+        renderTicks += SDL_GetPerformanceCounter() - start;
+        frames++;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busy = false;
+        }
+        done.notify_one();
+    }
+}
+
+}   //  namespace
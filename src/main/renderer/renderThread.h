@@ -0,0 +1,84 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#ifndef AB_RENDER_THREAD_H
+#define AB_RENDER_THREAD_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace AB {
+
+//  Pipelines frames across two threads. The main thread runs the simulation and Lua and
+//  records frame N+1 into the layers and render queue while this thread, which holds the GL
+//  context, sorts, packs and draws frame N and presents it. Frame time then tends towards
+//  the slower of the two instead of their sum.
+//
+//  The only sync points are submitFrame(), which waits for the previous frame to be drawn
+//  before handing over the next, and sync(), which code that needs GL on the main thread
+//  (resource loads, direct draws) calls to wait for the render thread and take the context.
+class RenderThread {
+    public:
+        void start();
+        void stop();
+
+        //  hands the recorded frame over and returns as soon as the previous one is done
+        void submitFrame();
+
+        //  waits for the render thread to go idle and makes the context current here
+        void sync();
+
+        b8 running = false;
+
+    private:
+        void threadMain();
+        void waitIdle();
+
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable wake, done;
+
+        b8 busy = false;
+        b8 quit = false;
+        b8 mainHasContext = true;
+
+        //  stats, in performance counter ticks
+        u64 frames = 0;
+        u64 waitTicks = 0;
+        u64 renderTicks = 0;
+};
+
+extern RenderThread renderThread;
+
+//  every GL entry point that can be reached from the main thread calls this first
+inline void syncRenderThread() {
+    if (renderThread.running) {
+        renderThread.sync();
+    }
+}
+
+}   //  namespace
+
+#endif
@@ -25,9 +25,14 @@ freely, subject to the following restrictions:
 #include "../pch.h"
 
 #include "renderer.h"
+#include "renderState.h"
+#include "renderThread.h"
 #include "../core/log.h"
 #include "renderLayer.h"
 #include "renderTarget.h"
+#include "textureArray.h"
+#include "spriteAtlas.h"
+#include "../core/window.h"
 
 #ifdef WIN32
 //  force use of discrete GPU
@@ -43,11 +48,18 @@ extern "C"
 
 namespace AB {
 
+extern Window window;
+
 GLuint whiteTexture;
 
 b8 Renderer::startup() {
     LOG("Renderer subsystem startup", 0);
 
+    //  GLES 3 and WebGL 2 always take NPOT textures
+#if !defined(ANDROID) && !defined(__EMSCRIPTEN__)
+    Texture::npotSupported = GLAD_GL_VERSION_2_0;
+#endif
+
     // create white texture
     CALL_GL(glGenTextures(1, &whiteTexture));
     if (!whiteTexture) {
@@ -72,12 +84,18 @@ b8 Renderer::startup() {
     // create render state, uniform buffer, etc
     CALL_GL(glGenBuffers(1, &ubo));
     CALL_GL(glBindBuffer(GL_UNIFORM_BUFFER, ubo));
-    CALL_GL(glBufferData(GL_UNIFORM_BUFFER, sizeof(uniforms), NULL, GL_STATIC_DRAW)); // allocate 152 bytes of memory (?)
+    CALL_GL(glBufferData(GL_UNIFORM_BUFFER, sizeof(uniforms), NULL, GL_DYNAMIC_DRAW));
     CALL_GL(glBindBuffer(GL_UNIFORM_BUFFER, 0));
     LOG_EXP(sizeof(uniforms));
 
+    uniforms.colorTransform = blend::identity();
+    uniforms.timer = 0;
+    uniforms.randomSeed = 0.0f;
+    memset(&frameStats, 0, sizeof(frameStats));
+
     CALL_GL(glEnable(GL_BLEND));
-    CALL_GL(glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA));
+    renderState.invalidate();
+    renderState.setBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 
     layers.clear();
     layers[0] = new RenderLayer(nullptr, nullptr, blend::identity(), true);
@@ -99,9 +117,14 @@ void Renderer::shutdown() {
     for (std::map<u32, RenderTarget*>::iterator i = canvases.begin(); i != canvases.end(); i++) {
         delete i->second;
     }
+    queues[0].releaseRetired();
+    queues[1].releaseRetired();
 
     CALL_GL(glDeleteBuffers(1, &fullscreenQuadVAO));
 
+    releaseTextureArrays();
+    releaseAtlas();
+
     CALL_GL(glDeleteTextures(1, &whiteTexture));
     CALL_GL(glDeleteBuffers(1, &ubo));
 
@@ -109,21 +132,95 @@ void Renderer::shutdown() {
 }
 
 void Renderer::clear(f32 r, f32 g, f32 b, f32 a) {
+    syncRenderThread();
     CALL_GL(glClearColor(r, g, b, a));
     CALL_GL(glClear(GL_COLOR_BUFFER_BIT));
 }
 
+void Renderer::beginDirectDraw() {
+    syncRenderThread();
+    if (recordingQueue->getTarget() != 0) {
+        ERR("Canvas %d is in use, but models, quad renderers and skyboxes only draw to the screen", recordingQueue->getTarget());
+    }
+    renderState.bindFramebuffer(0);
+    window.resetViewport();
+}
+
 void Renderer::renderFullscreenQuad() {
-    CALL_GL(glBindVertexArray(fullscreenQuadVAO));
+    syncRenderThread();
+    renderState.bindVertexArray(fullscreenQuadVAO);
     CALL_GL(glDrawArrays(GL_TRIANGLE_STRIP, 0, 4));
-    CALL_GL(glBindVertexArray(0));
+    renderState.stats.drawCalls++;
+    renderState.bindVertexArray(0);
+}
+
+void Renderer::submitLayers(const Camera& camera) {
+    u32 cameraIndex = recordingQueue->addCamera(camera);
+
+    for (std::map<u32, RenderLayer*>::iterator it = layers.begin(); it != layers.end(); it++) {
+        if (!it->second->isEmpty()) {
+            recordingQueue->drawLayer(it->first, it->second, it->second->submit(), cameraIndex);
+        }
+    }
+}
+
+void Renderer::setTarget(u32 canvas, const Camera& camera) {
+    submitLayers(camera);
+    recordingQueue->setTarget(canvas);
+}
+
+void Renderer::deleteCanvas(u32 canvas) {
+    auto iterator = canvases.find(canvas);
+    if (iterator == canvases.end()) {
+        return;
+    }
+
+    recordingQueue->retireTarget(canvas, iterator->second);
+    canvases.erase(iterator);
+}
+
+void Renderer::queueClear(f32 r, f32 g, f32 b, f32 a) {
+    recordingQueue->clear(r, g, b, a);
 }
 
 void Renderer::render(const Camera& camera) {
-    for (std::map<u32, RenderLayer*>::reverse_iterator it = layers.rbegin(); it != layers.rend(); it++) {
-        RenderLayer *renderLayer = it->second;
-        renderLayer->render(camera);
+    submitLayers(camera);
+
+    uniforms.projectionMatrix = camera.projectionMatrix;
+    uniforms.viewMatrix = camera.viewMatrix;
+
+    if (!pipelined) {
+        flipFrame();
+        executeFrame();
+    }
+}
+void Renderer::flipFrame() {
+    std::swap(recordingQueue, executingQueue);
+    recordingQueue->continueFrom(*executingQueue);
+
+    uniforms.timer = SDL_GetTicks();
+    uniforms.randomSeed = uniformRandom.rndf(0.0f, 1.0f);
+    frameUniforms = uniforms;
+
+    //  nothing is executing, so the render thread's counts can be read
+    frameStats = renderState.getLastFrame();
+
+    for (std::map<u32, RenderLayer*>::iterator it = layers.begin(); it != layers.end(); it++) {
+        it->second->flip();
+    }
+}
+void Renderer::executeFrame() {
+    CALL_GL(glBindBuffer(GL_UNIFORM_BUFFER, ubo));
+    CALL_GL(glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(frameUniforms), &frameUniforms));
+    CALL_GL(glBindBufferBase(GL_UNIFORM_BUFFER, Shader::FRAME_UNIFORM_BINDING, ubo));
+
+    executingQueue->execute(canvases);
+
+    for (std::map<u32, RenderLayer*>::iterator it = layers.begin(); it != layers.end(); it++) {
+        it->second->endFrame();
     }
+
+    renderState.endFrame();
 }
 
 }
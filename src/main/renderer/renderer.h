@@ -54,6 +54,9 @@ freely, subject to the following restrictions:
 #include "colorTransform.h"
 #include "renderTarget.h"
 #include "renderLayer.h"
+#include "renderQueue.h"
+#include "renderState.h"
+#include "../math/random.h"
 
 namespace AB {
 
@@ -67,24 +70,62 @@ class Renderer : public SubSystem {
         b8 startup();
         void shutdown();
         
+        //  submits whatever the layers hold, then sorts and draws the frame's render queue.
+        //  when pipelined the frame is only recorded, the render thread draws it later
         void render(const Camera& camera);
-        
+
+        //  hands the recorded frame over for execution and starts recording the next
+        void flipFrame();
+        void executeFrame();
+
+        b8 pipelined = false;
+
+        //  state churn of the last executed frame
+        const RenderState::Stats& getFrameStats() const { return frameStats; }
+
+        //  ends the current pass, drawing the layers so far with the given camera. later
+        //  drawing goes to the canvas (0 for the default framebuffer)
+        void setTarget(u32 canvas, const Camera& camera);
+
+        //  takes the canvas out of use now, but only deletes it once the frame's queue has run,
+        //  since draws recorded before this still go to it
+        void deleteCanvas(u32 canvas);
+
+        //  clears the current pass's target before any of its layers are drawn
+        void queueClear(f32 r, f32 g, f32 b, f32 a);
+
+        //  clears right away, for code drawing outside the queue
         void clear(f32 r, f32 g, f32 b, f32 a);
+
+        //  Model, QuadRenderer and Skybox draw straight away rather than through the queue, so
+        //  they land ahead of everything queued this frame, a queued clear included. they only
+        //  draw to the default framebuffer, which this binds after waiting for the render thread
+        void beginDirectDraw();
         void renderFullscreenQuad();
         
     private:
-        // no samplers in uniform blocks :(
+        //  bound once per frame for any shader declaring UniformBlock, laid out std140.
+        //  no samplers in uniform blocks :(
         struct Uniforms {
             Mat4 projectionMatrix;
             Mat4 viewMatrix;
             Mat4 colorTransform;
             u32 timer;
             f32 randomSeed;
-        } uniforms;
+            f32 padding[2];
+        } uniforms, frameUniforms;      //  recording, executing
+        static_assert(sizeof(Uniforms) == 208, "Uniforms should match the std140 block");
+
+        PRNG uniformRandom;     //  separate from the game's so replays stay in sync
+        RenderState::Stats frameStats;
         
         // struct State {} state;
         
-        //std::vector<RenderCommand> commandQueue;
+        RenderQueue queues[2];
+        RenderQueue *recordingQueue = &queues[0];
+        RenderQueue *executingQueue = &queues[1];
+
+        void submitLayers(const Camera& camera);
 
         GLuint ubo;        //    uniform buffer
         GLuint fullscreenQuadVAO;    
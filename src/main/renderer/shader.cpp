@@ -24,6 +24,8 @@ freely, subject to the following restrictions:
 
 #include "../pch.h"
 #include "shader.h"
+#include "renderState.h"
+#include "renderThread.h"
 
 #include "../core/log.h"
 #include "../core/fileSystem.h"
@@ -37,6 +39,7 @@ Shader::Shader() {}
 Shader::~Shader() {}
 
 void Shader::load(std::string const& filename) {
+    syncRenderThread();
     const int INFO_LOG_LENGTH = 1024;
 
     LOG("Loading shader <%s>", filename.c_str());
@@ -90,16 +93,27 @@ void Shader::load(std::string const& filename) {
         CALL_GL(glGetProgramInfoLog(shaderProgram, INFO_LOG_LENGTH, NULL, infoLog));
         ERR("%s: Shader program compilation failed: %s", filename.c_str(), infoLog);
     }
-    CALL_GL(glUseProgram(shaderProgram));
+    renderState.useProgram(shaderProgram);
 
-    GLint textureSamplers[16];
+    //    a new program means new locations
+    uniforms.clear();
+    uniformHandles.clear();
+
+    projection = getUniform("projection");
+    colorTransform = getUniform("colorTransform");
+    textureSamplers = getUniform("textureSamplers");
+    texture = getUniform("Texture");
+
+    GLint units[16];
     for (GLint i = 0; i < 16; i++) {
-        textureSamplers[i] = i;
+        units[i] = i;
     }
-    GLint textureSamplersLoc;
-    CALL_GL(textureSamplersLoc = glGetUniformLocation(shaderProgram, "textureSamplers"));
-    if (textureSamplersLoc != -1) {
-        CALL_GL(glUniform1iv(textureSamplersLoc, 16, textureSamplers));
+    setIntArray(textureSamplers, units, 16);
+
+    GLuint blockIndex;
+    CALL_GL(blockIndex = glGetUniformBlockIndex(shaderProgram, "UniformBlock"));
+    if (blockIndex != GL_INVALID_INDEX) {
+        CALL_GL(glUniformBlockBinding(shaderProgram, blockIndex, FRAME_UNIFORM_BINDING));
     }
 
     CALL_GL(glDeleteShader(vertexShader));
@@ -109,65 +123,112 @@ void Shader::load(std::string const& filename) {
 }
 
 void Shader::release() {
+    syncRenderThread();
     CALL_GL(glDeleteProgram(shaderProgram));
+    renderState.invalidate();
 }
 
 void Shader::bind() {
-    CALL_GL(glUseProgram(shaderProgram));
+    renderState.useProgram(shaderProgram);
 }
 
-void Shader::setBool(const std::string& name, bool value) {
-    GLint location = getUniformLocation(name);
-    CALL_GL(glUniform1i(location, value ? 1 : 0));
+Shader::Uniform Shader::getUniform(const std::string& name) {
+    auto iterator = uniformHandles.find(name);
+    if (iterator != uniformHandles.end()) {
+        return iterator->second;
+    }
+
+    UniformSlot slot;
+    CALL_GL(slot.location = glGetUniformLocation(shaderProgram, name.c_str()));
+    slot.size = 0;
+
+    Uniform uniform = uniforms.size();
+    uniforms.push_back(slot);
+    uniformHandles[name] = uniform;
+
+    return uniform;
 }
 
-void Shader::setInt(const std::string& name, int value) {
-    GLint location = getUniformLocation(name);
-    CALL_GL(glUniform1i(location, value));
+b8 Shader::changed(Uniform uniform, const void* value, u32 size) {
+    UniformSlot &slot = uniforms[uniform];
+
+    //    not in the program, or optimized out
+    if (slot.location == -1) {
+        return false;
+    }
+
+    if (slot.size == size && memcmp(slot.value, value, size) == 0) {
+        renderState.stats.uniformSkips++;
+        return false;
+    }
+
+    if (size <= MAX_SHADOWED_SIZE) {
+        memcpy(slot.value, value, size);
+        slot.size = size;
+    } else {
+        slot.size = 0;
+    }
+    renderState.stats.uniformUploads++;
+
+    //    glUniform* writes to whichever program is bound, so make sure it's this one
+    renderState.useProgram(shaderProgram);
+
+    return true;
+}
+
+void Shader::setBool(Uniform uniform, bool value) {
+    GLint data = value ? 1 : 0;
+    if (changed(uniform, &data, sizeof(data))) {
+        CALL_GL(glUniform1i(uniforms[uniform].location, data));
+    }
 }
 
-void Shader::setIntArray(const std::string& name, int* values, uint32_t count) {
-    GLint location = getUniformLocation(name);
-    CALL_GL(glUniform1iv(location, count, values));
+void Shader::setInt(Uniform uniform, int value) {
+    if (changed(uniform, &value, sizeof(value))) {
+        CALL_GL(glUniform1i(uniforms[uniform].location, value));
+    }
 }
 
-void Shader::setFloat(const std::string& name, float value) {
-    GLint location = getUniformLocation(name);
-    CALL_GL(glUniform1f(location, value));
+void Shader::setIntArray(Uniform uniform, int* values, uint32_t count) {
+    if (changed(uniform, values, sizeof(int) * count)) {
+        CALL_GL(glUniform1iv(uniforms[uniform].location, count, values));
+    }
 }
 
-void Shader::setVec2(const std::string& name, const Vec2& value) {
-    GLint location = getUniformLocation(name);
-    CALL_GL(glUniform2f(location, value.x, value.y));
+void Shader::setFloat(Uniform uniform, float value) {
+    if (changed(uniform, &value, sizeof(value))) {
+        CALL_GL(glUniform1f(uniforms[uniform].location, value));
+    }
 }
 
-void Shader::setVec3(const std::string& name, const Vec3& value) {
-    GLint location = getUniformLocation(name);
-    CALL_GL(glUniform3f(location, value.x, value.y, value.z));
+void Shader::setVec2(Uniform uniform, const Vec2& value) {
+    if (changed(uniform, &value, sizeof(value))) {
+        CALL_GL(glUniform2f(uniforms[uniform].location, value.x, value.y));
+    }
 }
 
-void Shader::setVec4(const std::string& name, const Vec4& value) {
-    GLint location = getUniformLocation(name);
-    CALL_GL(glUniform4f(location, value.x, value.y, value.z, value.w));
+void Shader::setVec3(Uniform uniform, const Vec3& value) {
+    if (changed(uniform, &value, sizeof(value))) {
+        CALL_GL(glUniform3f(uniforms[uniform].location, value.x, value.y, value.z));
+    }
 }
 
-void Shader::setMat3(const std::string& name, const Mat3& matrix) {
-    GLint location = getUniformLocation(name);
-    CALL_GL(glUniformMatrix3fv(location, 1, GL_FALSE, (f32*)(&matrix)));
+void Shader::setVec4(Uniform uniform, const Vec4& value) {
+    if (changed(uniform, &value, sizeof(value))) {
+        CALL_GL(glUniform4f(uniforms[uniform].location, value.x, value.y, value.z, value.w));
+    }
 }
 
-void Shader::setMat4(const std::string& name, const Mat4& matrix) {
-    GLint location = getUniformLocation(name);
-    //CALL_GL(glUniformMatrix4fv(location, 1, GL_FALSE, value_ptr(matrix)));
-    CALL_GL(glUniformMatrix4fv(location, 1, GL_FALSE, (f32*)(&matrix)));
+void Shader::setMat3(Uniform uniform, const Mat3& matrix) {
+    if (changed(uniform, &matrix, sizeof(matrix))) {
+        CALL_GL(glUniformMatrix3fv(uniforms[uniform].location, 1, GL_FALSE, (f32*)(&matrix)));
+    }
 }
 
-GLint Shader::getUniformLocation(const std::string& name) const {
-    if (uniformLocations.find(name) != uniformLocations.end()) {
-        return uniformLocations[name];
+void Shader::setMat4(Uniform uniform, const Mat4& matrix) {
+    if (changed(uniform, &matrix, sizeof(matrix))) {
+        CALL_GL(glUniformMatrix4fv(uniforms[uniform].location, 1, GL_FALSE, (f32*)(&matrix)));
     }
-    CALL_GL(uniformLocations[name] = glGetUniformLocation(shaderProgram, name.c_str()));
-    return uniformLocations[name];
 }
 
 std::string Shader::getHeader() {
@@ -42,23 +42,58 @@ class Shader : public Asset {
 
         void bind();
 
-        void setBool(const std::string& name, bool value);
-        void setInt(const std::string& name, int value);
-        void setIntArray(const std::string& name, int* values, uint32_t count);
-        void setFloat(const std::string& name, float value);
-        void setVec2(const std::string& name, const Vec2& value);
-        void setVec3(const std::string& name, const Vec3& value);
-        void setVec4(const std::string& name, const Vec4& value);
-        void setMat3(const std::string& name, const Mat3& matrix);
-        void setMat4(const std::string& name, const Mat4& matrix);
+        //    uniforms are set through handles into a shadow copy of the program's values, so
+        //    setting one to what it already holds never reaches GL. look handles up once with
+        //    getUniform(), the name based setters do it on every call
+        typedef i32 Uniform;
+        Uniform getUniform(const std::string& name);
+
+        void setBool(Uniform uniform, bool value);
+        void setInt(Uniform uniform, int value);
+        void setIntArray(Uniform uniform, int* values, uint32_t count);
+        void setFloat(Uniform uniform, float value);
+        void setVec2(Uniform uniform, const Vec2& value);
+        void setVec3(Uniform uniform, const Vec3& value);
+        void setVec4(Uniform uniform, const Vec4& value);
+        void setMat3(Uniform uniform, const Mat3& matrix);
+        void setMat4(Uniform uniform, const Mat4& matrix);
+
+        void setBool(const std::string& name, bool value) { setBool(getUniform(name), value); }
+        void setInt(const std::string& name, int value) { setInt(getUniform(name), value); }
+        void setIntArray(const std::string& name, int* values, uint32_t count) { setIntArray(getUniform(name), values, count); }
+        void setFloat(const std::string& name, float value) { setFloat(getUniform(name), value); }
+        void setVec2(const std::string& name, const Vec2& value) { setVec2(getUniform(name), value); }
+        void setVec3(const std::string& name, const Vec3& value) { setVec3(getUniform(name), value); }
+        void setVec4(const std::string& name, const Vec4& value) { setVec4(getUniform(name), value); }
+        void setMat3(const std::string& name, const Mat3& matrix) { setMat3(getUniform(name), matrix); }
+        void setMat4(const std::string& name, const Mat4& matrix) { setMat4(getUniform(name), matrix); }
 
         GLuint getProgram() { return shaderProgram; }
 
+        //    handles for the uniforms the engine sets itself, resolved at load
+        Uniform projection;
+        Uniform colorTransform;
+        Uniform textureSamplers;
+        Uniform texture;
+
+        //    binding point of the per-frame UniformBlock (see Renderer)
+        static const GLuint FRAME_UNIFORM_BINDING = 0;
+
     protected:
         static std::string getHeader();
 
-        GLint getUniformLocation(const std::string& name) const;
-        mutable std::unordered_map<std::string, GLint> uniformLocations;
+        //    true if the value differs from the shadow copy, which is then updated and the program
+        //    bound so the upload lands in it
+        b8 changed(Uniform uniform, const void* value, u32 size);
+
+        static const u32 MAX_SHADOWED_SIZE = 64;
+        struct UniformSlot {
+            GLint location;
+            u32 size;           //    0 until first set
+            u8 value[MAX_SHADOWED_SIZE];
+        };
+        std::vector<UniformSlot> uniforms;
+        std::unordered_map<std::string, Uniform> uniformHandles;
 
         GLuint shaderProgram;
 };
@@ -25,12 +25,31 @@ freely, subject to the following restrictions:
 #include "../pch.h"
 
 #include "skybox.h"
+#include "renderState.h"
+#include "renderThread.h"
 #include "image.h"
+#include "renderer.h"
 
 namespace AB {
 
+extern Renderer renderer;
+
 GLenum Skybox::filter = GL_NEAREST;
 
+//    cubemap faces were always uploaded bottom row first, the way TGAs are stored, and the
+//    shader's sampling assumes it. images are top down now, so copy the face out flipped. cellY
+//    counts face rows up from the bottom of the image, same as it did before
+static void uploadFace(GLenum target, const Image& image, u32 cellX, u32 cellY, u32 faceW, u32 faceH) {
+    u8* imageData = new u8[faceW * faceH * 4];
+    for (u32 y = 0; y < faceH; y++) {
+        u32 srcRow = image.height - 1 - (cellY * faceH + y);
+        u32 srcOfs = (srcRow * image.width + cellX * faceW) * 4;
+        memcpy(&imageData[y * faceW * 4], &image.data[srcOfs], faceW * 4);
+    }
+    glTexImage2D(target, 0, GL_RGBA, faceW, faceH, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
+    delete[] imageData;
+}
+
 void Skybox::init() {
     constexpr f32 skyboxVertices[] = {
         -1.0f,  1.0f, -1.0f,
@@ -79,7 +98,7 @@ void Skybox::init() {
     //    initialize VAO
     CALL_GL(glGenVertexArrays(1, &vao));
     CALL_GL(glGenBuffers(1, &vbo));
-    CALL_GL(glBindVertexArray(vao));
+    renderState.bindVertexArray(vao);
     CALL_GL(glBindBuffer(GL_ARRAY_BUFFER, vbo));
     CALL_GL(glBufferData(GL_ARRAY_BUFFER, sizeof(skyboxVertices), &skyboxVertices, GL_STATIC_DRAW));
     CALL_GL(glEnableVertexAttribArray(0));
@@ -97,9 +116,11 @@ void Skybox::init() {
     shader.load("shaders/skybox");
     shader.bind();
     shader.setInt("skybox", 0);
+    viewUniform = shader.getUniform("view");
 }
 
 Skybox::Skybox(std::vector<std::string> faces) {
+    syncRenderThread();
     if (faces.size() != 6) {
         ERR("Skyboxes have SIX (%d) faces. Six!", 6);
     }
@@ -110,14 +131,14 @@ Skybox::Skybox(std::vector<std::string> faces) {
     
     for (u32 i = 0; i < faces.size(); i++) {
         Image image(faces[i]);
-        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA, image.width, image.height,
-            0, GL_RGBA, GL_UNSIGNED_BYTE, image.data);
+        uploadFace(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, image, 0, 0, image.width, image.height);
     }
 
     init();
 }
 
 Skybox::Skybox(std::string cubemap) {
+    syncRenderThread();
     Image image(cubemap);
 
     u32 faceW = image.width / 4;
@@ -140,22 +161,14 @@ Skybox::Skybox(std::string cubemap) {
     };
 
     for (u32 i = 0; i < 6; i++) {
-        u32 cx = cells[i][0];
-        u32 cy = cells[i][1];
-        u8* imageData = new u8[faceW * faceH * 4];
-        for (u32 y = 0; y < faceH; y++) {
-            u32 srcOfs = ((cy * faceH + y) * image.width + cx * faceW) * 4;
-            memcpy(&imageData[y * faceW * 4], &image.data[srcOfs], faceW * 4);
-        }
-        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA,
-            faceW, faceH, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
-        delete[] imageData;
+        uploadFace(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, image, cells[i][0], cells[i][1], faceW, faceH);
     }
 
     init();
 }
     
 Skybox::~Skybox() {
+    syncRenderThread();
     shader.release();
 
     glDeleteTextures(1, &glHandle);
@@ -164,19 +177,21 @@ Skybox::~Skybox() {
 }
 
 void Skybox::render(const PerspectiveCamera& camera) {
+    renderer.beginDirectDraw();
     shader.bind();
     
     Mat4 viewMatrix = camera.viewMatrix;
     viewMatrix = Mat4(Mat3(viewMatrix)); // remove translation from the view matrix
 
-    shader.setMat4("projection", camera.projectionMatrix);
-    shader.setMat4("view", viewMatrix);
+    shader.setMat4(shader.projection, camera.projectionMatrix);
+    shader.setMat4(viewUniform, viewMatrix);
 
-    glBindVertexArray(vao);
+    renderState.bindVertexArray(vao);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_CUBE_MAP, glHandle);
     glDrawArrays(GL_TRIANGLES, 0, 36);
-    glBindVertexArray(0);
+    renderState.stats.drawCalls++;
+    renderState.bindVertexArray(0);
 }
 
 }
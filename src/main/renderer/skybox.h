@@ -37,6 +37,7 @@ class Skybox : public RenderLayer {
 
         static void setFilter(GLenum filter) { Skybox::filter = filter; }
         
+        //    draws right away, to the screen only (see Renderer::beginDirectDraw)
         void render(const PerspectiveCamera& camera);
         
     protected:
@@ -48,6 +49,7 @@ class Skybox : public RenderLayer {
         void init();
 
         Shader shader;
+        Shader::Uniform viewUniform;
         GLuint glHandle;       //  handle to OpenGL cubemap texture
 
         GLuint vao;            //  vertex array object
@@ -28,11 +28,14 @@ freely, subject to the following restrictions:
 #include "image.h"
 #include "../misc/misc.h"
 #include "renderer.h"
+#include "spriteAtlas.h"
 
 namespace AB {
 
 extern Renderer renderer;
 
+u32 Sprite::generation = 0;
+
 Sprite::Sprite() {
     image = NULL;
     texture = NULL;
@@ -54,7 +57,11 @@ void Sprite::load(std::string const& filename) {
 }
 
 void Sprite::release() {
+    //  the atlas keeps a pointer to every sprite it holds, and AssetManager::clear deletes
+    //  sprites right after releasing them
+    removeFromAtlas(this);
     texture.reset();
+    generation++;
 
     if (collisionMask) {
         delete[] collisionMask;
@@ -85,7 +92,7 @@ void Sprite::buildCollisionMask(u32 offsetX, u32 offsetY) {
     for (u32 y = offsetY; y < height + offsetY; y++) {
         for (u32 x = offsetX; x < width + offsetX; x++) {
             //  set true if alpha channel for pixel is above threshold
-            if (imageData[((image->height - y - 1) * image->width + x) * 4 + 3] > 128) {
+            if (imageData[(y * image->width + x) * 4 + 3] > 128) {
                 collisionMask[(y - offsetY) * width + (x - offsetX)] = true;
             }
         }
@@ -99,6 +106,7 @@ void Sprite::uploadToGPU(b8 retainImage) {
     v1 = 0.0f;
     u2 = texture->u2;
     v2 = texture->v2;
+    generation++;
 }
 
 void Sprite::adopt(std::shared_ptr<Texture> texture, f32 u1, f32 v1, f32 u2, f32 v2) {
@@ -107,16 +115,34 @@ void Sprite::adopt(std::shared_ptr<Texture> texture, f32 u1, f32 v1, f32 u2, f32
     this->v1 = v1;
     this->u2 = u2;
     this->v2 = v2;
+    generation++;
+}
+
+//  scales and rotates a trim offset the same way the batch shaders turn a quad's corners
+static Vec2 rotateOffset(Vec2 offset, f32 angle, f32 scaleX, f32 scaleY) {
+    f32 x = offset.x * scaleX;
+    f32 y = offset.y * scaleY;
+
+    return Vec2(x * cos(angle) + y * sin(angle), y * cos(angle) - x * sin(angle));
 }
 
 void Sprite::render(RenderLayer *renderer, Vec3 pos, f32 rotation, Vec2 scale, Vec4 color) {
     if (texture.get() == 0) {
         uploadToGPU();
     }
-    
+
+    renderer->renderQuad(makeQuad(pos, rotation, scale, color));
+}
+
+RenderLayer::Quad Sprite::makeQuad(Vec3 pos, f32 rotation, Vec2 scale, Vec4 color) const {
     RenderLayer::Quad quad;
     
     quad.pos = pos;
+    if (trimOffset.x != 0.0f || trimOffset.y != 0.0f) {
+        Vec2 offset = rotateOffset(trimOffset, rotation, scale.x, scale.y);
+        quad.pos.x += offset.x;
+        quad.pos.y += offset.y;
+    }
     quad.size = Vec2(width, height);
     quad.scale = scale;
     quad.rotation = rotation;
@@ -124,7 +150,7 @@ void Sprite::render(RenderLayer *renderer, Vec3 pos, f32 rotation, Vec2 scale, V
     quad.textureID = texture->glHandle;
     quad.color = color;
 
-    renderer->renderQuad(quad);
+    return quad;
 }
 
 struct Scan {
@@ -178,6 +204,10 @@ const void scanEdge(Vec2 p1, f32 u1, f32 v1, Vec2 p2,
 b8 collides(Sprite *s1, Vec2 pos1, f32 angle1, f32 scaleX1, f32 scaleY1,
     Sprite *s2, Vec2 pos2, f32 angle2, f32 scaleX2, f32 scaleY2) {
 
+    //  move trimmed sprites to where they're drawn, turned the same way as the corners below
+    pos1 += rotateOffset(s1->trimOffset, toRadians(-angle1), scaleX1, scaleY1);
+    pos2 += rotateOffset(s2->trimOffset, toRadians(-angle2), scaleX2, scaleY2);
+
     //  broad phase squared distance check
     f32 dist = (pos1.x - pos2.x) * (pos1.x - pos2.x) + (pos1.y - pos2.y) * (pos1.y - pos2.y);
     f32 sumRadii = abs(s1->radius * max(scaleX1, scaleY1)) + abs(s2->radius * max(scaleX2, scaleY2));
@@ -54,6 +54,10 @@ class Sprite : public Asset {
         void buildCollisionMask(u32 offsetX = 0, u32 offsetY = 0);
         void uploadToGPU(b8 retainImage = false);
         void render(RenderLayer *renderer, Vec3 pos, f32 rotation = 0.0f, Vec2 scale = Vec2(1.0f, 1.0f), Vec4 color = Vec4(1.0f, 1.0f, 1.0f, 1.0f));
+
+        //  the quad render() draws, trim offset and all, for code that fills batches itself.
+        //  the sprite has to be uploaded already
+        RenderLayer::Quad makeQuad(Vec3 pos, f32 rotation = 0.0f, Vec2 scale = Vec2(1.0f, 1.0f), Vec4 color = Vec4(1.0f, 1.0f, 1.0f, 1.0f)) const;
         
         std::shared_ptr<Texture> texture;
 
@@ -66,9 +70,17 @@ class Sprite : public Asset {
         f32 uSpan, vSpan;        //    percentage of actual size/padded size
         i32 halfX, halfY;        //  width and height / 2
 
+        //    sprites from packed atlases have their transparent borders trimmed off. this is where
+        //    the trimmed part's center sits relative to the center of the original image
+        Vec2 trimOffset;
+
         b8 *collisionMask;
         std::shared_ptr<Image> image;
 
+        //  bumped whenever any sprite's texture or UVs change, so code holding on to quads built
+        //  from sprites (TileMap) can tell when they've gone stale
+        static u32 generation;
+
 };
 
 extern b8 collides(Sprite *s1, Vec2 pos1, f32 angle1, f32 scaleX1, f32 scaleY1,
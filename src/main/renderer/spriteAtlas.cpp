@@ -25,30 +25,25 @@ freely, subject to the following restrictions:
 #include "../pch.h"
 
 #include "sprite.h"
+#include "renderThread.h"
 #include "../misc/misc.h"
 #include "../core/assetManager.h"
+#include "../core/fileSystem.h"
+#include "atlasFormat.h"
+#include "dynamicAtlas.h"
 #include "tga.h"
 
-namespace AB {
-
-class Node {
-    public:
-        Node(u32 x, u32 y, u32 w, u32 h) : x(x), y(y), w(w), h(h) {
-            used = false;
-            right = NULL;
-            down = NULL;
-        }
+#if !defined(__EMSCRIPTEN__) && !defined(ANDROID)
+#include <filesystem>
+#endif
 
-        u32 x, y, w, h;
-        b8 used;
-        Node *right;
-        Node *down;
-};
+namespace AB {
 
 static std::vector<Sprite*> atlasSprites;
-static Node *root;
+static DynamicAtlas *atlas = NULL;
 
 extern AssetManager<Sprite> sprites;
+extern FileSystem fileSystem;
 
 void addToAtlas(Sprite *sprite) {
     atlasSprites.push_back(sprite);
@@ -58,169 +53,41 @@ static b8 cmp(Sprite *s1, Sprite *s2) {
     return (max(s1->width, s1->height) > max(s2->width, s2->height));
 }
 
-static Node* splitNode(Node* node, u32 w, u32 h) {
-    node->used = true;
-    node->down = new Node(node->x, node->y + h, node->w, node->h - h);
-    node->right = new Node(node->x + w, node->y, node->w - w, h);
-
-    return node;
-}
-
-static Node* findNode(Node *root, u32 w, u32 h) {
-    if (root->used) {
-        Node* right = findNode(root->right, w, h);
-        if (right) {
-            return right;
-        } else {
-            return findNode(root->down, w, h);
-        }
-    } else if ((w <= root->w) && (h <= root->h)) {
-        return root;
-    }
-    return NULL;
-}
-
-static Node* growDown(u32 w, u32 h) {
-    Node* oldRoot = root;
-
-    root = new Node(0, 0, oldRoot->w, oldRoot->h + h);
-    root->used = true;
-    root->down = new Node(0, oldRoot->h, oldRoot->w, h);
-    root->right = oldRoot;
-
-    Node *node = findNode(root, w, h);
-    if (node) {
-        return splitNode(node, w, h);
-    } else {
-        return NULL;
+void buildAtlas() {
+    if (atlasSprites.empty()) {
+        return;
     }
-}
-
-static Node* growRight(u32 w, u32 h) {
-    Node* oldRoot = root;
 
-    root = new Node(0, 0, oldRoot->w + w, oldRoot->h);
-    root->used = true;
-    root->down = oldRoot;
-    root->right = new Node(oldRoot->w, 0, w, oldRoot->h);
-
-    Node *node = findNode(root, w, h);
-    if (node) {
-        return splitNode(node, w, h);
-    } else {
-        return NULL;
+    if (!atlas) {
+        atlas = new DynamicAtlas();
     }
-}
 
-static Node* growNode(Node *root, u32 w, u32 h) {
-    b8 canGrowDown = (w <= root->w);
-    b8 canGrowRight = (w <= root->w);
-
-    b8 shouldGrowRight = canGrowRight && (root->h >= (root->w + w));
-    b8 shouldGrowDown = canGrowDown && (root->w >= (root->h + h));
-
-    if (shouldGrowRight) {
-        return growRight(w, h);
-    } else if (shouldGrowDown) {
-        return growDown(w, h);
-    } else if (canGrowRight) {
-        return growRight(w, h);
-    } else if (canGrowDown) {
-        return growDown(w, h);
-    } else {
-        return NULL;
-    }
-}
+    //  sort sprites based on longest edge
+    std::sort(atlasSprites.begin(), atlasSprites.end(), cmp);
 
-static void fit() {
-    for (std::vector<Sprite*>::iterator sprite = atlasSprites.begin(); sprite != atlasSprites.end(); sprite++) {
-        Node *node = findNode(root, (*sprite)->width, (*sprite)->height);
-        if (node) {
-            Node* fit = splitNode(node, (*sprite)->width, (*sprite)->height);
-            (*sprite)->atlasX = fit->x;
-            (*sprite)->atlasY = fit->y;
-        } else {
-            Node* fit = growNode(root, (*sprite)->width, (*sprite)->height);
-            (*sprite)->atlasX = fit->x;
-            (*sprite)->atlasY = fit->y;
+    for (auto sprite : atlasSprites) {
+        if (!atlas->add(sprite)) {
+            LOG("%dx%d sprite doesn't fit in an atlas page, it keeps its own texture", sprite->width, sprite->height);
         }
     }
-}
-
-static void deleteTree(Node* node) {
-    if (node) {
-        deleteTree(node->right);
-        deleteTree(node->down);
+    atlas->upload();
 
-        delete node;
-        node = NULL;
-    }
+    atlasSprites.clear();
 }
 
-void buildAtlas() {
-    //  sort sprites based on longest edge
-    std::sort(atlasSprites.begin(), atlasSprites.end(), cmp);
-
-    //  initialize the target to the size of the largest sprite
-    root = new Node(0, 0, atlasSprites.at(0)->width, atlasSprites.at(0)->height);
-    fit();
-    u32 atlasWidth = root->w;
-    u32 atlasHeight = root->h;
-    deleteTree(root);
-
-    LOG_EXP(atlasWidth);
-    LOG_EXP(atlasHeight);
-
-    //  create atlas texture width root->w, root->h size
-    atlasWidth = nextPowerOfTwo(atlasWidth);
-    atlasHeight = nextPowerOfTwo(atlasHeight);
-    std::shared_ptr<Texture> atlas = std::make_shared<Texture>(atlasWidth, atlasHeight);
-
-    u8 *data = NULL;
-    data = new u8[atlasWidth * atlasHeight * 4];
-    memset(data, 0, atlasWidth * atlasHeight * 4);
-
-/*
-    loop through sprites:
-        use atlasX, atlasY to compute new U/Vs
-        draw sprite to atlas texture
-        delete sprite tga data
-        set sprite gl texture to atlas texture
-    upload atlas texture to gpu
-*/
-
-    for (std::vector<Sprite*>::iterator sprite = atlasSprites.begin(); sprite != atlasSprites.end(); sprite++) {
-        f32 u1 = (f32)(*sprite)->atlasX / (f32)atlasWidth;
-        f32 v1 = (f32)(*sprite)->atlasY / (f32)atlasHeight;
-        f32 u2 = (f32)((*sprite)->atlasX + (*sprite)->width) / (f32)atlasWidth;
-        f32 v2 = (f32)((*sprite)->atlasY + (*sprite)->height) / (f32)atlasHeight;
-
-        //  draw sprite to atlas texture
-        u8 *imageData = (*sprite)->image->data;
-
-        for (u32 y = 0; y < (*sprite)->height; y++) {
-            memcpy(&data[((y + (*sprite)->atlasY) * atlasWidth + (*sprite)->atlasX)* 4],
-               &imageData[((*sprite)->height - 1 - y) * (*sprite)->width * 4], (*sprite)->width * 4);
-        }
-
-        LOG("-------",0);
-        LOG_EXP((*sprite)->atlasX);
-        LOG_EXP((*sprite)->atlasY);
+void removeFromAtlas(Sprite *sprite) {
+    atlasSprites.erase(std::remove(atlasSprites.begin(), atlasSprites.end(), sprite), atlasSprites.end());
 
-        (*sprite)->adopt(atlas, u1, v1, u2, v2);
+    if (atlas) {
+        atlas->remove(sprite);
     }
-    CALL_GL(glActiveTexture(GL_TEXTURE0));
-    CALL_GL(glBindTexture(GL_TEXTURE_2D, atlas->glHandle));
-    CALL_GL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, atlasWidth, atlasHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, data));
-
-    // saveTGA(data, atlasWidth, atlasHeight, "atlas.tga");
-
-    atlas.reset();
-    delete [] data;
+}
 
-    //  TODO: check if grown past MAX_TEXTURE_SIZE and split
+void releaseAtlas() {
     atlasSprites.clear();
-    // GL_MAX_TEXTURE_SIZE
+
+    delete atlas;
+    atlas = NULL;
 }
 
 void defineSpriteFromAtlas(u32 atlasIndex, f32 u1, f32 v1, f32 u2, f32 v2, u32 spriteIndex, b8 buildCollisionMask) {
@@ -290,5 +157,120 @@ u32 loadAtlas(std::string const& filename, u32 firstIndex, u32 width, u32 height
     return numSprites;
 }
 
+#if !defined(__EMSCRIPTEN__) && !defined(ANDROID)
+//  during development the .atlas directory is still loose files under assets/, not packed yet.
+//  its TGAs go into the shared DynamicAtlas instead, mapped and named the way the asset compiler
+//  would have. they aren't trimmed, so spriteSize returns the untrimmed size until it's packed
+static b8 loadLooseAtlas(std::string const& filename, u32 firstIndex, std::vector<std::string>& names, b8 buildCollisionMasks, u32& spritesLoaded) {
+    std::filesystem::path directory = std::filesystem::path("assets") / filename;
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error)) {
+        return false;
+    }
+
+    std::vector<std::string> files;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".tga") {
+            files.push_back(entry.path().lexically_relative(directory).generic_string());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    for (u32 i = 0; i < files.size(); i++) {
+        u32 spriteIndex = firstIndex + i;
+        sprites.mapAsset(spriteIndex, filename + "/" + files[i]);
+        Sprite* sprite = sprites.get(spriteIndex);
+        if (buildCollisionMasks) {
+            sprite->buildCollisionMask();
+        }
+        addToAtlas(sprite);
+
+        names.push_back(files[i].substr(0, files[i].length() - 4));
+    }
+    buildAtlas();
+
+    spritesLoaded = files.size();
+    return true;
+}
+#endif
+
+u32 loadPackedAtlas(std::string const& filename, u32 firstIndex, std::vector<std::string>& names, b8 buildCollisionMasks) {
+    names.clear();
+
+#if !defined(__EMSCRIPTEN__) && !defined(ANDROID)
+    u32 spritesLoaded;
+    if (loadLooseAtlas(filename, firstIndex, names, buildCollisionMasks, spritesLoaded)) {
+        return spritesLoaded;
+    }
+#endif
+
+    DataObject dataObject = fileSystem.loadAsset(filename);
+    const u8* data = dataObject.getData();
+    u64 size = dataObject.getSize();
+    if (data == nullptr || size < sizeof(AtlasHeader) || memcmp(data, ATLAS_MAGIC, sizeof(ATLAS_MAGIC)) != 0) {
+        ERR("<%s> isn't a packed atlas. They're built by the asset compiler from .atlas directories", filename.c_str());
+        return 0;
+    }
+
+    AtlasHeader header;
+    memcpy(&header, data, sizeof(AtlasHeader));
+    if (header.version != ATLAS_VERSION) {
+        ERR("Atlas <%s> is version %d, expected %d. Rebuild the archive", filename.c_str(), header.version, ATLAS_VERSION);
+        return 0;
+    }
+
+    u64 namesOffset = sizeof(AtlasHeader) + (u64)header.entryCount * sizeof(AtlasEntry);
+    if (namesOffset + header.namesSize > size) {
+        ERR("Atlas <%s> is truncated", filename.c_str());
+        return 0;
+    }
+    const char* nameBlock = reinterpret_cast<const char*>(data + namesOffset);
+
+    //  pages are texture blobs next to the table, ready to upload
+    std::vector<std::shared_ptr<Image>> images;
+    std::vector<std::shared_ptr<Texture>> textures;
+    for (u32 page = 0; page < header.pageCount; page++) {
+        auto image = std::make_shared<Image>(filename + "." + std::to_string(page) + ".tga");
+        textures.push_back(std::make_shared<Texture>(image));
+        images.push_back(image);
+    }
+
+    for (u32 i = 0; i < header.entryCount; i++) {
+        AtlasEntry entry;
+        memcpy(&entry, data + sizeof(AtlasHeader) + (u64)i * sizeof(AtlasEntry), sizeof(AtlasEntry));
+        if (entry.page >= header.pageCount || entry.nameOffset >= header.namesSize) {
+            ERR("Atlas <%s> is corrupt", filename.c_str());
+            return i;
+        }
+
+        u32 spriteIndex = firstIndex + i;
+        sprites.mapAsset(spriteIndex, ".");
+        Sprite* sprite = sprites.get(spriteIndex);
+
+        sprite->width = entry.width;
+        sprite->height = entry.height;
+        sprite->halfX = entry.width / 2;
+        sprite->halfY = entry.height / 2;
+        sprite->radius = sqrt((f32)((sprite->halfX * sprite->halfX) + (sprite->halfY * sprite->halfY)));
+        sprite->trimOffset = Vec2(entry.trimX + (entry.width - entry.sourceWidth) * 0.5f,
+            entry.trimY + (entry.height - entry.sourceHeight) * 0.5f);
+
+        if (buildCollisionMasks) {
+            sprite->image = images[entry.page];
+            sprite->buildCollisionMask(entry.x, entry.y);
+            sprite->image = NULL;
+        }
+
+        std::shared_ptr<Texture> texture = textures[entry.page];
+        sprite->adopt(texture,
+            (f32)entry.x / (f32)texture->width, (f32)entry.y / (f32)texture->height,
+            (f32)(entry.x + entry.width) / (f32)texture->width, (f32)(entry.y + entry.height) / (f32)texture->height);
+
+        names.push_back(std::string(nameBlock + entry.nameOffset, strnlen(nameBlock + entry.nameOffset, header.namesSize - entry.nameOffset)));
+    }
+
+    return header.entryCount;
+}
+
 }   //  namespace
 
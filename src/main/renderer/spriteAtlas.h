@@ -29,12 +29,21 @@ freely, subject to the following restrictions:
 
 namespace AB {
 
+//  sprites queued with addToAtlas go into a shared DynamicAtlas when buildAtlas is called. it can
+//  be built again later, new sprites go in around the ones already there
 void addToAtlas(Sprite *sprite);
 void buildAtlas();
+void removeFromAtlas(Sprite *sprite);
+void releaseAtlas();
 
 void defineSpriteFromAtlas(u32 atlasIndex, f32 u1, f32 v1, f32 u2, f32 v2, u32 spriteIndex, b8 buildCollisionMask = true);
 u32 loadAtlas(std::string const& filename, u32 firstIndex, u32 width, u32 height, b8 buildCollisionMasks = false);
 
+//  loads an atlas the asset compiler packed from a .atlas directory. sprites are mapped from firstIndex
+//  on in name order, and names is filled with each one's name (its path in the directory, no extension).
+//  if the directory is still loose files on disk its images go into the shared atlas instead
+u32 loadPackedAtlas(std::string const& filename, u32 firstIndex, std::vector<std::string>& names, b8 buildCollisionMasks = false);
+
 }   //  namespace
 
 #endif // AB_SPRITE_ATLAS_H
@@ -0,0 +1,320 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#include "../pch.h"
+
+#include "staticLayer.h"
+#include "textureArray.h"
+#include "renderState.h"
+#include "renderThread.h"
+#include "../core/log.h"
+
+namespace AB {
+
+//    Shader::load points textureSamplers at units 0 - 15. runs remap them, so put them back after
+static GLint identityUnits[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+StaticLayer::StaticLayer(Shader *batchShader, Mat4 colorTransform, bool depthSorting, bool textureArrays, bool packedInstances)
+    : RenderLayer(batchShader, nullptr, colorTransform, depthSorting, textureArrays, packedInstances) {
+
+    mode = IDLE;
+    recordStart = 0;
+    updateFirst = 0;
+    offset = Vec2(0.0f, 0.0f);
+
+    CALL_GL(glGenBuffers(1, &staticVBO));
+    staticVBOSize = 0;
+}
+
+StaticLayer::~StaticLayer() {
+    syncRenderThread();
+    glDeleteBuffers(1, &staticVBO);
+}
+
+void StaticLayer::beginStatic() {
+    if (mode != IDLE) {
+        ERR("beginStatic() inside beginStatic() / beginUpdate()", 0);
+    }
+    mode = RECORDING;
+    recordStart = quadBatch.size();
+}
+
+void StaticLayer::beginUpdate(u32 first) {
+    if (mode != IDLE) {
+        ERR("beginUpdate() inside beginStatic() / beginUpdate()", 0);
+    }
+    mode = UPDATING;
+    recordStart = quadBatch.size();
+    updateFirst = first;
+}
+
+u32 StaticLayer::endStatic() {
+    if (mode == IDLE) {
+        ERR("endStatic() without beginStatic() / beginUpdate()", 0);
+        return staticQuads.size();
+    }
+
+    //    the render thread reads the retained quads and their buffer
+    syncRenderThread();
+
+    if (mode == RECORDING) {
+        staticQuads.assign(quadBatch.begin() + recordStart, quadBatch.end());
+        build();
+    } else {
+        b8 rebuild = false;
+        u32 dirtyBegin = 0xFFFFFFFF;
+        u32 dirtyEnd = 0;
+
+        for (u32 i = recordStart; i < quadBatch.size(); i++) {
+            const Quad& quad = quadBatch[i];
+            u32 index = updateFirst + (i - recordStart);
+
+            if (index >= staticQuads.size()) {
+                staticQuads.push_back(quad);
+                rebuild = true;
+                continue;
+            }
+
+            //    a new texture or depth moves the quad to another run
+            b8 moved = quad.textureID != staticQuads[index].textureID ||
+                (depthSorting && quad.pos.z != staticQuads[index].pos.z);
+            staticQuads[index] = quad;
+
+            if (moved) {
+                rebuild = true;
+            } else if (!rebuild) {
+                u32 slot = slots[index];
+                GLint textureID = gpuQuads[slot].textureID;
+                gpuQuads[slot] = quad;
+                gpuQuads[slot].textureID = textureID;
+
+                dirtyBegin = min(dirtyBegin, slot);
+                dirtyEnd = max(dirtyEnd, slot + 1);
+            }
+        }
+
+        if (rebuild) {
+            build();
+        } else if (dirtyBegin < dirtyEnd) {
+            upload(dirtyBegin, dirtyEnd - dirtyBegin);
+        }
+    }
+
+    quadBatch.resize(recordStart);
+    mode = IDLE;
+
+    return staticQuads.size();
+}
+
+void StaticLayer::build() {
+    u32 count = staticQuads.size();
+
+    gpuQuads = staticQuads;
+    sortBatch(gpuQuads);
+
+    slots.resize(count);
+    if (count < 2 || !sorting) {
+        //    nothing was reordered
+        for (u32 i = 0; i < count; i++) {
+            slots[i] = i;
+        }
+    } else {
+        //    sortBatch leaves the permutation in sortKeys
+        for (u32 i = 0; i < count; i++) {
+            slots[sortKeys[i].index] = i;
+        }
+    }
+
+    //    resolve textures once here instead of every frame. quads sharing a texture are
+    //    together after the sort, and up to 16 textures can share a run
+    runs.clear();
+    for (u32 runStart = 0; runStart < count;) {
+        GLint textureID = gpuQuads[runStart].textureID;
+        u32 runEnd = runStart + 1;
+        while (runEnd < count && gpuQuads[runEnd].textureID == textureID) {
+            runEnd++;
+        }
+
+        if (textureID == 0) {
+            textureID = whiteTexture;
+        }
+
+        GLuint handle = textureID;
+        i32 layer = -1;
+        b8 arrayRun = false;
+        if (textureArrays) {
+            arrayRun = ((GLuint)textureID == whiteTexture) || findTextureArray(textureID, handle, layer);
+        }
+        b8 needsTexture = !arrayRun || layer != -1;
+
+        StaticRun *run = runs.empty() ? nullptr : &runs.back();
+        i32 index = -1;
+        if (run && run->arrayRun == arrayRun && needsTexture) {
+            for (u32 i = 0; i < run->textureCount; i++) {
+                if (run->textures[i] == handle) {
+                    index = i;
+                    break;
+                }
+            }
+        }
+        if (!run || run->arrayRun != arrayRun || (needsTexture && index == -1 && run->textureCount == MAX_RUN_TEXTURES)) {
+            runs.emplace_back();
+            run = &runs.back();
+            run->first = runStart;
+            run->count = 0;
+            run->arrayRun = arrayRun;
+            run->textureCount = 0;
+        }
+        if (needsTexture && index == -1) {
+            index = run->textureCount;
+            run->textures[run->textureCount++] = handle;
+        }
+
+        GLint value = (arrayRun && index != -1) ? (index | (layer << 4)) : index;
+        for (u32 i = runStart; i < runEnd; i++) {
+            gpuQuads[i].textureID = value;
+        }
+        run->count += runEnd - runStart;
+
+        runStart = runEnd;
+    }
+
+    upload(0, count);
+}
+
+void StaticLayer::upload(u32 first, u32 count) {
+    size_t stride = packedInstances ? sizeof(PackedQuad) : sizeof(Quad);
+    size_t size = gpuQuads.size() * stride;
+
+    CALL_GL(glBindBuffer(GL_ARRAY_BUFFER, staticVBO));
+
+    //    grow the buffer to fit, reuploading everything
+    if (size > staticVBOSize) {
+        CALL_GL(glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STATIC_DRAW));
+        staticVBOSize = size;
+        first = 0;
+        count = gpuQuads.size();
+    }
+    if (count == 0) {
+        return;
+    }
+
+    if (packedInstances) {
+        packQuads(gpuQuads, first, count);
+        CALL_GL(glBufferSubData(GL_ARRAY_BUFFER, first * stride, count * stride, &packedBatch[0]));
+    } else {
+        CALL_GL(glBufferSubData(GL_ARRAY_BUFFER, first * stride, count * stride, &gpuQuads[first]));
+    }
+}
+
+void StaticLayer::renderStatic(const Camera& camera, Vec2 offset) {
+    if (runs.empty()) {
+        return;
+    }
+
+    Mat4 projection = camera.projectionMatrix;
+    projection = projection * translate(Vec3(offset.x, offset.y, 0.0f));
+
+    renderState.bindVertexArray(batchVAO);
+
+    size_t stride = packedInstances ? sizeof(PackedQuad) : sizeof(Quad);
+    Shader *currentShader = nullptr;
+
+    for (auto& run : runs) {
+        Shader *runShader;
+        if (run.arrayRun) {
+            runShader = packedInstances ? &defaultArrayPackedBatchShader : &defaultArrayBatchShader;
+        } else {
+            runShader = (packedInstances && batchShader == &defaultBatchShader) ? &defaultPackedBatchShader : batchShader;
+        }
+        if (runShader != currentShader) {
+            if (currentShader) {
+                currentShader->setIntArray(currentShader->textureSamplers, identityUnits, 16);
+            }
+            runShader->bind();
+            runShader->setMat4(runShader->projection, projection);
+            runShader->setMat4(runShader->colorTransform, colorTransform);
+            currentShader = runShader;
+        }
+
+        //    a run has at most 16 textures, so with every slot up for grabs they all fit
+        textureCache.advanceFrame();
+        GLint units[MAX_RUN_TEXTURES];
+        for (u32 i = 0; i < run.textureCount; i++) {
+            units[i] = textureCache.bindTexture(run.textures[i], false, run.arrayRun ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D);
+        }
+        if (run.textureCount > 0) {
+            currentShader->setIntArray(currentShader->textureSamplers, units, run.textureCount);
+        }
+
+        CALL_GL(glBindBuffer(GL_ARRAY_BUFFER, staticVBO));
+        setInstanceAttributes(run.first * stride);
+
+        CALL_GL(glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, run.count));
+        renderState.stats.drawCalls++;
+    }
+
+    currentShader->setIntArray(currentShader->textureSamplers, identityUnits, 16);
+    textureCache.advanceFrame();
+}
+
+void StaticLayer::render(const Camera& camera) {
+    syncRenderThread();
+
+    renderStatic(camera, offset);
+    RenderLayer::render(camera);
+}
+
+u32 StaticLayer::submit() {
+    if (mode != IDLE) {
+        ERR("Static layer submitted between beginStatic() / beginUpdate() and endStatic()", 0);
+    }
+    u32 submission = RenderLayer::submit();
+
+    std::vector<Vec2>& offsets = submittedOffsets[recordingSet];
+    if (submission >= offsets.size()) {
+        offsets.resize(submission + 1);
+    }
+    offsets[submission] = offset;
+
+    return submission;
+}
+
+void StaticLayer::render(const Camera& camera, u32 submission) {
+    renderStatic(camera, submittedOffsets[recordingSet ^ 1][submission]);
+    RenderLayer::render(camera, submission);
+}
+
+size_t StaticLayer::getReservedBytes() const {
+    size_t bytes = RenderLayer::getReservedBytes();
+
+    bytes += staticQuads.capacity() * sizeof(Quad);
+    bytes += gpuQuads.capacity() * sizeof(Quad);
+    bytes += slots.capacity() * sizeof(u32);
+    bytes += runs.capacity() * sizeof(StaticRun);
+
+    return bytes;
+}
+
+}   //  namespace
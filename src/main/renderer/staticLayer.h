@@ -0,0 +1,102 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#ifndef AB_STATIC_LAYER_H
+#define AB_STATIC_LAYER_H
+
+#include "renderLayer.h"
+
+namespace AB {
+
+//  A RenderLayer for things that don't change from frame to frame: backgrounds, tile layers,
+//  HUD frames. Quads drawn between beginStatic() and endStatic() are kept, sorted and uploaded
+//  once into a buffer that stays on the GPU, then redrawn every frame without being touched.
+//  Anything drawn outside of that goes through the usual batch, on top of the retained quads.
+//
+//  Changing retained quads calls syncRenderThread(), so keep it out of the per-frame path.
+class StaticLayer : public RenderLayer {
+    public:
+        StaticLayer(Shader *batchShader = &defaultBatchShader, Mat4 colorTransform = Mat4(), bool depthSorting = false, bool textureArrays = false, bool packedInstances = false);
+        virtual ~StaticLayer();
+
+        //    throws away the retained quads. what's drawn until endStatic() replaces them
+        void beginStatic();
+
+        //    what's drawn until endStatic() overwrites retained quads, in the order they were first
+        //    drawn, starting at first. only the changed range is uploaded unless textures changed
+        //    or quads were added, which rebuilds everything
+        void beginUpdate(u32 first);
+
+        //    sorts and uploads. returns the number of retained quads
+        u32 endStatic();
+
+        u32 getStaticCount() const { return staticQuads.size(); }
+
+        //    added to the position of every retained quad when drawn, for scrolling. taken at
+        //    submit time so it's safe to change every frame
+        Vec2 offset;
+
+        void render(const Camera& camera) override;
+        u32 submit() override;
+        void render(const Camera& camera, u32 submission) override;
+        bool isEmpty() const override { return staticQuads.empty() && RenderLayer::isEmpty(); }
+        size_t getReservedBytes() const override;
+
+    private:
+        void build();
+        void upload(u32 first, u32 count);
+        void renderStatic(const Camera& camera, Vec2 offset);
+
+        //    a draw's worth of retained quads. each quad's textureID indexes this run's textures
+        static const u32 MAX_RUN_TEXTURES = 16;
+        struct StaticRun {
+            u32 first;
+            u32 count;
+            b8 arrayRun;
+            u32 textureCount;
+            GLuint textures[MAX_RUN_TEXTURES];
+        };
+
+        enum Mode {
+            IDLE,
+            RECORDING,
+            UPDATING,
+        } mode;
+        u32 recordStart;        //    index in quadBatch where the static quads start
+        u32 updateFirst;
+
+        std::vector<Quad> staticQuads;      //    as drawn, with texture handles
+        std::vector<Quad> gpuQuads;         //    sorted, with run texture indices, as uploaded
+        std::vector<u32> slots;             //    where each of staticQuads ended up in gpuQuads
+        std::vector<StaticRun> runs;
+
+        GLuint staticVBO;
+        size_t staticVBOSize;
+
+        std::vector<Vec2> submittedOffsets[2];
+};
+
+}   //  namespace
+
+#endif
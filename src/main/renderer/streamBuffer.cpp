@@ -0,0 +1,156 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#include "../pch.h"
+
+#include "streamBuffer.h"
+#include "../core/log.h"
+
+#if defined(__EMSCRIPTEN__) || defined(ANDROID)
+#define AB_STREAM_SUBDATA
+#endif
+
+namespace AB {
+
+void StreamBuffer::init(GLenum target, size_t regionSize, u32 regionCount) {
+    this->target = target;
+    this->regionSize = regionSize;
+    this->regionCount = regionCount < 1 ? 1 : (regionCount > MAX_REGIONS ? MAX_REGIONS : regionCount);
+
+    for (u32 i = 0; i < MAX_REGIONS; i++) {
+        fences[i] = 0;
+    }
+
+    CALL_GL(glGenBuffers(1, &glHandle));
+    allocate();
+}
+
+void StreamBuffer::release() {
+    for (u32 i = 0; i < regionCount; i++) {
+        if (fences[i]) {
+            glDeleteSync(fences[i]);
+            fences[i] = 0;
+        }
+    }
+
+    glDeleteBuffers(1, &glHandle);
+    glHandle = 0;
+}
+
+void StreamBuffer::allocate() {
+    //    orphans the old storage, if any. the driver keeps it alive until pending draws are done
+    CALL_GL(glBindBuffer(target, glHandle));
+    CALL_GL(glBufferData(target, regionSize * regionCount, NULL, GL_STREAM_DRAW));
+
+    for (u32 i = 0; i < regionCount; i++) {
+        if (fences[i]) {
+            glDeleteSync(fences[i]);
+            fences[i] = 0;
+        }
+    }
+
+    currentRegion = 0;
+    writeOffset = 0;
+}
+
+void StreamBuffer::waitForRegion(u32 region) {
+    if (!fences[region]) {
+        return;
+    }
+
+    //    flush on the first try so the fence is guaranteed to signal eventually
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (true) {
+        GLenum result = glClientWaitSync(fences[region], flags, 1000000);
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED) {
+            break;
+        }
+        flags = 0;
+    }
+
+    glDeleteSync(fences[region]);
+    fences[region] = 0;
+}
+
+size_t StreamBuffer::upload(const void* data, size_t size, size_t alignment) {
+#ifdef AB_STREAM_SUBDATA
+    CALL_GL(glBindBuffer(target, glHandle));
+    if (size > regionSize * regionCount) {
+        regionSize = size;
+        regionCount = 1;
+        allocate();
+    }
+    CALL_GL(glBufferSubData(target, 0, size, data));
+
+    return 0;
+#else
+    size_t offset = (writeOffset + alignment - 1) / alignment * alignment;
+
+    if (offset + size > regionSize) {
+        //    this frame doesn't fit, start over in a bigger buffer
+        while (size > regionSize) {
+            regionSize *= 2;
+        }
+        regionSize *= 2;
+        LOG("Stream buffer grown to %d bytes", (i32)(regionSize * regionCount));
+
+        allocate();
+        offset = 0;
+    } else {
+        CALL_GL(glBindBuffer(target, glHandle));
+    }
+
+    GLintptr absoluteOffset = currentRegion * regionSize + offset;
+    void *dest = glMapBufferRange(target, absoluteOffset, size,
+        GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+
+    if (dest) {
+        memcpy(dest, data, size);
+        CALL_GL(glUnmapBuffer(target));
+    } else {
+        CALL_GL(glBufferSubData(target, absoluteOffset, size, data));
+    }
+
+    writeOffset = offset + size;
+
+    return absoluteOffset;
+#endif
+}
+
+void StreamBuffer::advanceFrame() {
+#ifndef AB_STREAM_SUBDATA
+    if (writeOffset == 0) {
+        return;
+    }
+
+    fences[currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    currentRegion = (currentRegion + 1) % regionCount;
+    writeOffset = 0;
+
+    waitForRegion(currentRegion);
+#endif
+}
+
+}
@@ -0,0 +1,73 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#ifndef AB_STREAM_BUFFER_H
+#define AB_STREAM_BUFFER_H
+
+namespace AB {
+
+//  Dynamic vertex data that gets rewritten every frame. The buffer is split into regions and
+//  each frame writes into the next one with unsynchronized maps, so the driver never has to
+//  wait on draws still reading from the last frame. A fence guards each region in case the
+//  GPU falls that far behind. If a frame outgrows its region the buffer is orphaned at twice
+//  the size.
+//
+//  GLES / WebGL has no unsynchronized mapping, so there it uploads to the start of the buffer
+//  with glBufferSubData like before.
+class StreamBuffer {
+    public:
+        StreamBuffer() {}
+        ~StreamBuffer() {}
+
+        void init(GLenum target, size_t regionSize, u32 regionCount = 3);
+        void release();
+
+        //  copies data into the current region and returns its byte offset in the buffer.
+        //  offsets are a multiple of alignment, so pass the vertex stride to draw with 'first'
+        size_t upload(const void* data, size_t size, size_t alignment = 4);
+
+        //  fences the region just written and moves on to the next one. call once per frame,
+        //  after everything that frame has been drawn
+        void advanceFrame();
+
+        GLuint glHandle = 0;
+
+    private:
+        void allocate();
+        void waitForRegion(u32 region);
+
+        GLenum target;
+        size_t regionSize;
+        u32 regionCount;
+
+        u32 currentRegion;
+        size_t writeOffset;     //    relative to the start of the current region
+
+        static const u32 MAX_REGIONS = 4;
+        GLsync fences[MAX_REGIONS];
+};
+
+}
+
+#endif
@@ -44,7 +44,10 @@ freely, subject to the following restrictions:
 #include "../pch.h"
 
 #include "texture.h"
+#include "textureFormat.h"
 #include "tga.h"
+#include "textureArray.h"
+#include "renderThread.h"
 #include "../math/math.h"
 #include "../core/log.h"
 
@@ -53,12 +56,14 @@ namespace AB {
 GLenum Texture::minFilter = GL_NEAREST;
 GLenum Texture::magFilter = GL_NEAREST;
 GLenum Texture::wrapMode = GL_REPEAT;
+b8 Texture::npotSupported = true;
 
 Texture::Texture() {
     glHandle = 0;
 }
 
 Texture::Texture(u32 width, u32 height) {
+    syncRenderThread();
     CALL_GL(glGenTextures(1, &glHandle));
     if (!glHandle) {
         ERR("Couldn't create texture!", 0);
@@ -80,26 +85,31 @@ Texture::Texture(std::shared_ptr<Image> image) {
     init(image);
 }
 
-void Texture::init(std::shared_ptr<Image> image) {
-    u32 rWidth = image->width;
-    u32 rHeight = image->height;
-    width = nextPowerOfTwo(rWidth);
-    height = nextPowerOfTwo(rHeight);
-
-    u2 = ((f32)rWidth - 0.01f) / (f32)width;
-    v2 = ((f32)rHeight - 0.01f) / (f32)height;
-
-    //  create new image padded to ^2
-    u8 *data = NULL;
-    data = new u8[width * height * 4];
-    memset(data, 0, width * height * 4);
-    u8 *imageData = NULL;
-    imageData = image->data;
-
-    for (u32 y = 0; y < rHeight; y++) {
-        memcpy(&data[(rHeight - y - 1) * width * 4], &imageData[y * rWidth * 4], rWidth * 4);
+//  sizes the texture for an image and gives it storage, filled from data if there is any. data
+//  is top down RGBA, imageWidth * imageHeight of it
+void Texture::allocate(u32 imageWidth, u32 imageHeight, const u8* data) {
+    width = npotSupported ? imageWidth : nextPowerOfTwo(imageWidth);
+    height = npotSupported ? imageHeight : nextPowerOfTwo(imageHeight);
+
+    u2 = ((f32)imageWidth - 0.01f) / (f32)width;
+    v2 = ((f32)imageHeight - 0.01f) / (f32)height;
+
+    if (width == imageWidth && height == imageHeight) {
+        CALL_GL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data));
+        return;
     }
 
+    //  padded fallback. the padding is cleared so filtering at the edges doesn't pick up garbage
+    std::vector<u8> blank(width * height * 4, 0);
+    CALL_GL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, blank.data()));
+    if (data) {
+        CALL_GL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, imageWidth, imageHeight, GL_RGBA, GL_UNSIGNED_BYTE, data));
+    }
+}
+
+void Texture::init(std::shared_ptr<Image> image) {
+    syncRenderThread();
+
     //  create OGL texture
     CALL_GL(glGenTextures(1, &glHandle));
     if (!glHandle) {
@@ -113,11 +123,17 @@ void Texture::init(std::shared_ptr<Image> image) {
     CALL_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapMode));
     CALL_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapMode));
 
-    CALL_GL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data));
-
-    if (data) {
-        delete [] data;
-        data = NULL;
+    //  images are already top down, so they go up as they are
+    allocate(image->width, image->height, image->data);
+
+    //  mipmaps from the asset compiler follow the first level. padded textures go without
+    if (image->mipLevels > 1 && width == image->width && height == image->height) {
+        const u8* level = image->data + image->imageSize;
+        for (u32 i = 1; i < image->mipLevels; i++) {
+            CALL_GL(glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA8, max(width >> i, 1U), max(height >> i, 1U), 0, GL_RGBA, GL_UNSIGNED_BYTE, level));
+            level += textureLevelSize(width, height, i);
+        }
+        CALL_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image->mipLevels - 1));
     }
 }
 
@@ -127,7 +143,9 @@ Texture::Texture(std::string const& filename) {
 }
 
 Texture::~Texture() {
+    syncRenderThread();
     glDeleteTextures(1, &glHandle);
+    forgetTextureArray(glHandle);
 }
 
 }   //  namespace
@@ -43,6 +43,8 @@ freely, subject to the following restrictions:
 #include <SDL2/SDL.h>
 #endif
 
+#include <memory>
+
 #include "image.h"
 
 namespace AB {
@@ -65,13 +67,18 @@ class Texture {
         //  defaults to GL_REPEAT but you may also want GL_CLAMP_TO_EDGE
         static void setWrapMode(GLenum mode) { Texture::wrapMode = mode; }
 
-        u32 width, height;        //  size padded to nearest 2^
+        u32 width, height;        //  size of the GL texture, padded to nearest 2^ without NPOT support
         f32 u2, v2;
 
         static GLenum minFilter, magFilter, wrapMode;
 
+        //  set at renderer startup. without it textures are padded out to a power of two, and
+        //  u2, v2 say how much of that the image covers
+        static b8 npotSupported;
+
     protected:
         void init(std::shared_ptr<Image> image);
+        void allocate(u32 imageWidth, u32 imageHeight, const u8* data);
 };
 
 }   //  namespace
@@ -0,0 +1,201 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#include "../pch.h"
+
+#include <unordered_map>
+
+#include "textureArray.h"
+#include "renderThread.h"
+#include "../core/log.h"
+
+namespace AB {
+
+//  spec minimum for GL_MAX_ARRAY_TEXTURE_LAYERS in GL 3.3 and GLES 3.0
+static const u32 MAX_LAYERS = 256;
+
+struct ArrayLayer {
+    GLuint arrayHandle;
+    i32 layer;
+};
+
+static std::vector<std::shared_ptr<Texture>> queuedTextures;
+static std::unordered_map<GLuint, ArrayLayer> arrayLayers;
+static std::vector<GLuint> arrayHandles;
+
+void addToTextureArray(Sprite *sprite) {
+    if (!sprite->texture) {
+        ERR("Sprite has no texture to add to a texture array", 0);
+        return;
+    }
+
+    //  atlas sprites share a page, only queue it once
+    for (auto& texture : queuedTextures) {
+        if (texture->glHandle == sprite->texture->glHandle) {
+            return;
+        }
+    }
+    if (arrayLayers.find(sprite->texture->glHandle) != arrayLayers.end()) {
+        return;
+    }
+
+    queuedTextures.push_back(sprite->texture);
+}
+
+//  textures don't keep their pixels, so they're copied across on the GPU through a read
+//  framebuffer. the caller binds the framebuffer and the array
+static b8 copyLayer(GLuint textureID, i32 layer, u32 width, u32 height) {
+    CALL_GL(glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureID, 0));
+    if (glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        ERR("Couldn't read texture %d into texture array", textureID);
+        return false;
+    }
+    CALL_GL(glCopyTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, 0, 0, width, height));
+
+    return true;
+}
+
+static GLuint createArray(u32 width, u32 height, u32 layers) {
+    GLuint handle;
+    CALL_GL(glGenTextures(1, &handle));
+    if (!handle) {
+        ERR("Couldn't create texture array!", 0);
+    }
+
+    CALL_GL(glActiveTexture(GL_TEXTURE0));
+    CALL_GL(glBindTexture(GL_TEXTURE_2D_ARRAY, handle));
+
+    CALL_GL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, Texture::minFilter));
+    CALL_GL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, Texture::magFilter));
+    CALL_GL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, Texture::wrapMode));
+    CALL_GL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, Texture::wrapMode));
+
+    CALL_GL(glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
+
+    return handle;
+}
+
+void buildTextureArrays() {
+    syncRenderThread();
+    if (queuedTextures.empty()) {
+        return;
+    }
+
+    //  group pages by size. atlas pages mostly share a handful of sizes, loose sprites may not
+    std::stable_sort(queuedTextures.begin(), queuedTextures.end(),
+        [](const std::shared_ptr<Texture>& t1, const std::shared_ptr<Texture>& t2) {
+            return t1->width != t2->width ? t1->width < t2->width : t1->height < t2->height;
+        });
+
+    GLint previousFramebuffer;
+    CALL_GL(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousFramebuffer));
+
+    GLuint fbo;
+    CALL_GL(glGenFramebuffers(1, &fbo));
+    CALL_GL(glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo));
+
+    u32 first = 0;
+    while (first < queuedTextures.size()) {
+        u32 width = queuedTextures[first]->width;
+        u32 height = queuedTextures[first]->height;
+
+        u32 last = first;
+        while (last < queuedTextures.size() && last - first < MAX_LAYERS &&
+            queuedTextures[last]->width == width && queuedTextures[last]->height == height) {
+            last++;
+        }
+
+        GLuint handle = createArray(width, height, last - first);
+        arrayHandles.push_back(handle);
+
+        for (u32 i = first; i < last; i++) {
+            GLuint textureID = queuedTextures[i]->glHandle;
+            i32 layer = i - first;
+
+            if (copyLayer(textureID, layer, width, height)) {
+                arrayLayers[textureID] = { handle, layer };
+            }
+        }
+
+        LOG("Texture array %dx%d, %d layers", width, height, last - first);
+        first = last;
+    }
+
+    CALL_GL(glBindFramebuffer(GL_READ_FRAMEBUFFER, previousFramebuffer));
+    CALL_GL(glDeleteFramebuffers(1, &fbo));
+
+    queuedTextures.clear();
+}
+
+void releaseTextureArrays() {
+    syncRenderThread();
+    for (auto handle : arrayHandles) {
+        CALL_GL(glDeleteTextures(1, &handle));
+    }
+    arrayHandles.clear();
+    arrayLayers.clear();
+    queuedTextures.clear();
+}
+
+void refreshTextureArray(GLuint textureID, u32 width, u32 height) {
+    auto iterator = arrayLayers.find(textureID);
+    if (iterator == arrayLayers.end()) {
+        return;
+    }
+
+    syncRenderThread();
+    GLint previousFramebuffer;
+    CALL_GL(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousFramebuffer));
+
+    GLuint fbo;
+    CALL_GL(glGenFramebuffers(1, &fbo));
+    CALL_GL(glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo));
+    CALL_GL(glActiveTexture(GL_TEXTURE0));
+    CALL_GL(glBindTexture(GL_TEXTURE_2D_ARRAY, iterator->second.arrayHandle));
+
+    if (!copyLayer(textureID, iterator->second.layer, width, height)) {
+        arrayLayers.erase(iterator);
+    }
+
+    CALL_GL(glBindFramebuffer(GL_READ_FRAMEBUFFER, previousFramebuffer));
+    CALL_GL(glDeleteFramebuffers(1, &fbo));
+}
+
+void forgetTextureArray(GLuint textureID) {
+    arrayLayers.erase(textureID);
+}
+
+b8 findTextureArray(GLuint textureID, GLuint &arrayHandle, i32 &layer) {
+    auto iterator = arrayLayers.find(textureID);
+    if (iterator == arrayLayers.end()) {
+        return false;
+    }
+
+    arrayHandle = iterator->second.arrayHandle;
+    layer = iterator->second.layer;
+
+    return true;
+}
+
+}   //  namespace
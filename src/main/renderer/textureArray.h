@@ -0,0 +1,52 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#ifndef AB_TEXTURE_ARRAY_H
+#define AB_TEXTURE_ARRAY_H
+
+#include "sprite.h"
+
+namespace AB {
+
+//  Sprite pages of the same size can be copied into the layers of a GL_TEXTURE_2D_ARRAY, so a
+//  render layer with texture arrays enabled draws them with a single texture unit. Queue the
+//  sprites at startup like addToAtlas, then build once everything is loaded. The original 2D
+//  textures are left alone for layers that don't use arrays.
+void addToTextureArray(Sprite *sprite);
+void buildTextureArrays();
+void releaseTextureArrays();
+
+//  copies a texture into its layer again after its pixels have changed. does nothing if it
+//  isn't in an array
+void refreshTextureArray(GLuint textureID, u32 width, u32 height);
+
+//  called when a texture is deleted. its GL name can be handed out again to an unrelated texture
+void forgetTextureArray(GLuint textureID);
+
+//  looks up the array and layer a 2D texture was copied into. returns false if it wasn't
+b8 findTextureArray(GLuint textureID, GLuint &arrayHandle, i32 &layer);
+
+}   //  namespace
+
+#endif // AB_TEXTURE_ARRAY_H
@@ -52,9 +52,13 @@ namespace AB {
 
 TextureCache::TextureCache() {
     frameID = 1;
+
+    for (u32 i = 0; i < MAX_TEXTURE_UNITS; i++) {
+        textureBindings[i] = CachedTexture(0, 0);
+    }
 }
 
-i32 TextureCache::bindTexture(GLuint textureID, bool reserve) {
+i32 TextureCache::bindTexture(GLuint textureID, bool reserve, GLenum target) {
     i32 oldestIndex = 0;
     u32 oldestFrame = frameID;
 
@@ -82,9 +86,10 @@ i32 TextureCache::bindTexture(GLuint textureID, bool reserve) {
 
     textureBindings[unit].textureID = textureID;
     textureBindings[unit].lastFrame = frameID;
+    textureBindings[unit].target = target;
 
     CALL_GL(glActiveTexture(GL_TEXTURE0 + unit));
-    CALL_GL(glBindTexture(GL_TEXTURE_2D, textureID));
+    CALL_GL(glBindTexture(target, textureID));
 
     return unit;
 }
@@ -100,7 +105,7 @@ void TextureCache::evictTexture(u32 textureID) {
             textureBindings[i].lastFrame = 0;
 
             CALL_GL(glActiveTexture(GL_TEXTURE0 + i));
-            CALL_GL(glBindTexture(GL_TEXTURE_2D, 0));
+            CALL_GL(glBindTexture(textureBindings[i].target, 0));
         }
     }
 }
@@ -112,6 +117,8 @@ void TextureCache::invalidate() {
 
         CALL_GL(glActiveTexture(GL_TEXTURE0 + i));
         CALL_GL(glBindTexture(GL_TEXTURE_2D, 0));
+        CALL_GL(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+        textureBindings[i].target = GL_TEXTURE_2D;
     }
 }
 
@@ -35,7 +35,7 @@ class TextureCache {
         //    returns texture unit or -1 if no slot available
         //    will not evict textures bound after the last call to advanceFrame
         //    reserve is not currently used
-        i32 bindTexture(u32 textureID, bool reserve = false);
+        i32 bindTexture(u32 textureID, bool reserve = false, GLenum target = GL_TEXTURE_2D);
         
         //  resets all slots to fair game
         void advanceFrame();
@@ -54,10 +54,11 @@ class TextureCache {
         
         struct CachedTexture {
             CachedTexture() {}
-            CachedTexture(u32 textureID, u32 lastFrame) : textureID(textureID), lastFrame(lastFrame) {}
+            CachedTexture(u32 textureID, u32 lastFrame) : textureID(textureID), lastFrame(lastFrame), target(GL_TEXTURE_2D) {}
 
             u32 textureID;
             u32 lastFrame;
+            GLenum target;      //  GL_TEXTURE_2D or GL_TEXTURE_2D_ARRAY
         } textureBindings[MAX_TEXTURE_UNITS];
 
 };
@@ -0,0 +1,61 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#ifndef AB_TEXTURE_FORMAT_H
+#define AB_TEXTURE_FORMAT_H
+
+#include "../types.h"
+
+namespace AB {
+
+//  GPU ready image written by the asset compiler in place of each TGA, keeping the TGA's name.
+//  Pixels are RGBA8, premultiplied and top down, so they go to glTexImage2D as they are. Laid
+//  out as:
+//
+//      TextureHeader
+//      mip level 0, width * height * 4 bytes
+//      mip level n, max(width >> n, 1) * max(height >> n, 1) * 4 bytes, for each further level
+
+static const char TEXTURE_MAGIC[4] = { 'A', 'B', 'T', 'X' };
+static const u32 TEXTURE_VERSION = 1;
+
+struct TextureHeader {
+    char magic[4];
+    u32 version;
+    u32 width, height;
+    u32 mipLevels;          //  1 for no mipmaps
+    u32 reserved;
+};
+
+static_assert(sizeof(TextureHeader) == 24, "TextureHeader must be packed");
+
+inline u64 textureLevelSize(u32 width, u32 height, u32 level) {
+    u64 levelWidth = width >> level ? width >> level : 1;
+    u64 levelHeight = height >> level ? height >> level : 1;
+    return levelWidth * levelHeight * 4;
+}
+
+}   //  namespace
+
+#endif
@@ -27,7 +27,8 @@ freely, subject to the following restrictions:
     @file tga.cpp
     @date 10.25.10
 
-    Loads a TGA file! Currently supports 32 or 24 bit depths.
+    Loads a TGA file! Currently supports 32 or 24 bit depths. Pixels come out as top down,
+    premultiplied RGBA whatever the source depth.
 
 */
 
@@ -38,6 +39,7 @@ freely, subject to the following restrictions:
 #include <cstring>
 
 #include "tga.h"
+#include "pixelConvert.h"
 #include "../core/fileSystem.h"
 #include "../core/log.h"
 #include "../math/math.h"
@@ -56,48 +58,14 @@ static void swapRB(u8 *data, u32 width, u32 height, u32 bpp) {
     }
 }
 
-static void flipImage(u8 *data, u32 width, u32 height, u32 bpp) {
-    u8 bTemp;
-    u8 *pLine1, *pLine2;
-    u32 iLineLen, iIndex;
-
-    iLineLen = width * (bpp / 8);
-    pLine1 = data;
-    pLine2 = &data[iLineLen * (height - 1)];
-
-    for(; pLine1 < pLine2; pLine2 -= (iLineLen * 2)) {
-        for (iIndex = 0; iIndex != iLineLen; pLine1++, pLine2++, iIndex++) {
-            bTemp = *pLine1;
-            *pLine1 = *pLine2;
-            *pLine2 = bTemp;
-        }
-    }
-}
-
-static void premultiplyAlpha(u8 *data, u32 width, u32 height, u32 bpp) {
-    u32 size = width * height;
-    
-    for (u32 i = 0; i < size; i++) {
-        f32 r = data[i * 4 + 0] / 255.0f;
-        f32 g = data[i * 4 + 1] / 255.0f;
-        f32 b = data[i * 4 + 2] / 255.0f;
-        f32 a = data[i * 4 + 3] / 255.0f;
-        
-        r *= a;
-        g *= a;
-        b *= a;
-        
-        data[i * 4 + 0] = round(r * 255.0f);
-        data[i * 4 + 1] = round(g * 255.0f);
-        data[i * 4 + 2] = round(b * 255.0f);
-    }
-}
-
 u8* loadTGA(const std::string& filename, u32 &width, u32 &height, u32 &bpp) {
     DataObject dataObject = fileSystem.loadAsset(filename);
 
+    return decodeTGA(dataObject.getData(), dataObject.getSize(), filename, width, height, bpp);
+}
+
+u8* decodeTGA(const u8* data, u64 size, const std::string& filename, u32 &width, u32 &height, u32 &bpp) {
     //  read header
-    u8* data = dataObject.getData();
     if (data == nullptr) {
         ERR("Unable to read file: %s", filename.c_str());
     }
@@ -134,13 +102,15 @@ u8* loadTGA(const std::string& filename, u32 &width, u32 &height, u32 &bpp) {
     bpp = data[16];
     LOG("\tWidth: %d, Height: %d, BPP: %d", width, height, bpp);
 
-    if (data[17] > 32) {
+    if (data[17] & 0xC0) {
         ERR("Interleaved data unsupported", 0);
     }
 
-    //  calculate image size // and verify file size not suspect
-    //    TODO: will this work for RLE images?
-    u32 imageSize = (width * height * (bpp / 8));
+    if (bpp != 24 && bpp != 32) {
+        ERR("Unsupported bit depth %d", bpp);
+    }
+    u32 pixelSize = bpp / 8;
+    u32 imageSize = width * height * 4;
 
     //  color map type. if this is 1, the image is indexed. screwy. bail.
     if (data[1] != 0) {
@@ -153,58 +123,79 @@ u8* loadTGA(const std::string& filename, u32 &width, u32 &height, u32 &bpp) {
         ERR("Unable to allocate memory for image", 0);
     }
     short offset = data[0] + 18;
-    
+
+    //  rows are written out top down as they're decoded, already swizzled and premultiplied,
+    //  so nothing touches the image twice. TGAs are bottom up unless the origin bit in the
+    //  descriptor says otherwise
+    u32 rowSize = width * 4;
+    b8 topDown = (data[17] & 0x20) != 0;
+    auto row = [&](u32 y) {
+        return &imageData[(topDown ? y : height - 1 - y) * rowSize];
+    };
+    auto convert = pixelSize == 4 ? convertBGRA : convertBGR;
+
     // unmapped RGB
     if (encoding == 2) {
-        if (imageSize + 18 + data[0] > (u32)dataObject.getSize()) {
+        if ((u64)width * height * pixelSize + offset > size) {
             ERR("Bad image format", 0);
         }
-        memcpy(imageData, &data[offset], imageSize);
+        for (u32 y = 0; y < height; y++) {
+            convert(row(y), &data[offset + y * width * pixelSize], width);
+        }
     }
-    
+
     //    RLE RGB
     if (encoding == 10) {
-        //    pixel size in bytes
-        u32 pixelSize = bpp / 8;
-        
-        u8* current = &data[offset];
-        u32 index = 0;
-
-        // decode RLE data
-        while (index < imageSize) {
-            if (*current & 0x80) {
-                //    run length chunk (high bit == 1)
-                u8 runLength = *current - 127;
-                current++;
-                
-                for (u32 loop = 0; loop != runLength; loop++, index += pixelSize) {
-                    memcpy(&imageData[index], current, pixelSize);
-                }
-                
+        const u8* current = &data[offset];
+        const u8* end = data + size;
+        u32 y = 0;
+        u32 x = 0;
+
+        //  packets can carry on past the end of a row, so they're split into spans
+        while (y < height && current < end) {
+            b8 run = (*current & 0x80) != 0;
+            u32 length = (*current & 0x7F) + 1;
+            current++;
+
+            if (current + (run ? 1 : length) * pixelSize > end) {
+                ERR("Bad image format", 0);
+                break;
+            }
+
+            if (run) {
+                //  convert the pixel once, then copy it out
+                u8 pixel[4];
+                convert(pixel, current, 1);
                 current += pixelSize;
+
+                while (length > 0 && y < height) {
+                    u32 span = std::min(length, width - x);
+                    u8* destination = row(y) + x * 4;
+                    for (u32 i = 0; i < span; i++, destination += 4) {
+                        memcpy(destination, pixel, 4);
+                    }
+                    length -= span;
+                    x += span;
+                    if (x == width) {
+                        x = 0;
+                        y++;
+                    }
+                }
             } else {
-                //    raw chunk
-                u8 chunkLength = *current + 1;
-                current++;
-                
-                for (u32 loop = 0; loop != chunkLength; loop++, index += pixelSize, current += pixelSize) {
-                    memcpy(&imageData[index], current, pixelSize);
+                while (length > 0 && y < height) {
+                    u32 span = std::min(length, width - x);
+                    convert(row(y) + x * 4, current, span);
+                    current += span * pixelSize;
+                    length -= span;
+                    x += span;
+                    if (x == width) {
+                        x = 0;
+                        y++;
+                    }
                 }
             }
         }
     }
-    
-    swapRB(imageData, width, height, bpp);
-    
-    //  flip image
-    if ((data[17] & 0x10)) {
-        flipImage(imageData, width, height, bpp);
-    }
-
-    //    premultiply alpha
-    if (bpp == 32) {
-        premultiplyAlpha(imageData, width, height, bpp);
-    }
 
     return imageData;
 }
@@ -218,7 +209,7 @@ void saveTGA(u8* data, const u32 width, const u32 height, const std::string& fil
 
     u8 TGAheader[12]={0,0,2,0,0,0,0,0,0,0,0,0};
     u8 header[6] = { (u8)(width % 256), (u8)(width / 256),
-        (u8)(height % 256), (u8)(height / 256), 32, 0};
+        (u8)(height % 256), (u8)(height / 256), 32, 0x28};   //  top down, like Image
 
     swapRB(data, width, height, 32);
 
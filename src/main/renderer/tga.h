@@ -28,7 +28,8 @@ freely, subject to the following restrictions:
     @author Andrew Krause - contact@alienbug.net
     @date 10.25.10
 
-    Loads TGA files. Currently supports 32 or 24 bit depths.
+    Loads TGA files. Currently supports 32 or 24 bit depths. Either way the result is
+    top down, premultiplied RGBA and bpp reports what the file held.
 
 */
 
@@ -40,6 +41,7 @@ freely, subject to the following restrictions:
 namespace AB {
 
 u8* loadTGA(const std::string& filename, u32 &width, u32 &height, u32 &bpp);
+u8* decodeTGA(const u8* data, u64 size, const std::string& filename, u32 &width, u32 &height, u32 &bpp);
 void saveTGA(u8* data, const u32 width, const u32 height, const std::string& filename);
 
 }   // namespace
@@ -0,0 +1,225 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#include "../pch.h"
+
+#include "tileMap.h"
+#include "sprite.h"
+#include "../core/log.h"
+
+namespace AB {
+
+extern AssetManager<Sprite> sprites;
+
+TileMap::TileMap(u32 width, u32 height, u32 tileWidth, u32 tileHeight)
+    : width(max(width, 1u)), height(max(height, 1u)), tileWidth(max(tileWidth, 1u)), tileHeight(max(tileHeight, 1u)) {
+
+    //    ERR is compiled out of release builds, which get the nearest size that works instead
+    if (width == 0 || height == 0) {
+        ERR("Tile map must be at least 1x1 (got %dx%d)", width, height);
+    }
+    if (tileWidth == 0 || tileHeight == 0) {
+        ERR("Tiles must be at least 1x1 (got %dx%d)", tileWidth, tileHeight);
+    }
+
+    chunksX = (this->width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    chunksY = (this->height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    tiles.assign(this->width * this->height, 0);
+    chunks.resize(chunksX * chunksY);
+    for (auto& chunk : chunks) {
+        chunk.dirty = false;
+    }
+    spriteGeneration = Sprite::generation;
+}
+
+void TileMap::setTile(u32 x, u32 y, u16 tile) {
+    if (x >= width || y >= height) {
+        return;
+    }
+    u16& current = tiles[y * width + x];
+    if (current != tile) {
+        current = tile;
+        chunks[(y / CHUNK_SIZE) * chunksX + x / CHUNK_SIZE].dirty = true;
+    }
+}
+
+void TileMap::setTiles(u32 x, u32 y, u32 w, u32 h, const u16* source) {
+    if (x >= width || y >= height) {
+        return;
+    }
+    u32 copyW = min(w, width - x);
+    u32 copyH = min(h, height - y);
+
+    for (u32 row = 0; row < copyH; row++) {
+        memcpy(&tiles[(y + row) * width + x], source + row * w, copyW * sizeof(u16));
+    }
+    markDirty(x, y, copyW, copyH);
+}
+
+void TileMap::getTiles(u32 x, u32 y, u32 w, u32 h, u16* destination) const {
+    for (u32 row = 0; row < h; row++) {
+        for (u32 column = 0; column < w; column++) {
+            u32 tileX = x + column;
+            u32 tileY = y + row;
+            destination[row * w + column] = (tileX < width && tileY < height) ? tiles[tileY * width + tileX] : 0;
+        }
+    }
+}
+
+void TileMap::fill(u32 x, u32 y, u32 w, u32 h, u16 tile) {
+    if (x >= width || y >= height) {
+        return;
+    }
+    u32 fillW = min(w, width - x);
+    u32 fillH = min(h, height - y);
+
+    for (u32 row = 0; row < fillH; row++) {
+        std::fill_n(&tiles[(y + row) * width + x], fillW, tile);
+    }
+    markDirty(x, y, fillW, fillH);
+}
+
+void TileMap::invalidate() {
+    for (auto& chunk : chunks) {
+        chunk.dirty = true;
+    }
+}
+
+void TileMap::markDirty(u32 x, u32 y, u32 w, u32 h) {
+    if (w == 0 || h == 0) {
+        return;
+    }
+    for (u32 chunkY = y / CHUNK_SIZE; chunkY <= (y + h - 1) / CHUNK_SIZE; chunkY++) {
+        for (u32 chunkX = x / CHUNK_SIZE; chunkX <= (x + w - 1) / CHUNK_SIZE; chunkX++) {
+            chunks[chunkY * chunksX + chunkX].dirty = true;
+        }
+    }
+}
+
+void TileMap::buildChunk(u32 chunkX, u32 chunkY) {
+    Chunk& chunk = chunks[chunkY * chunksX + chunkX];
+    chunk.quads.clear();
+    chunk.dirty = false;
+
+    u32 endX = min((chunkX + 1) * CHUNK_SIZE, width);
+    u32 endY = min((chunkY + 1) * CHUNK_SIZE, height);
+
+    for (u32 y = chunkY * CHUNK_SIZE; y < endY; y++) {
+        for (u32 x = chunkX * CHUNK_SIZE; x < endX; x++) {
+            u16 tile = tiles[y * width + x];
+            if (tile == 0) {
+                continue;
+            }
+
+            //    unmapped tiles are left empty rather than loading a sprite with no file
+            if (!sprites.find(tile) && sprites.assetInfo.find(tile) == sprites.assetInfo.end()) {
+                LOG("Tile %d has no sprite mapped", tile);
+                continue;
+            }
+
+            Sprite *sprite = sprites.get(tile);
+            if (sprite->texture.get() == 0) {
+                sprite->uploadToGPU();
+            }
+
+            //    sprites are centered on their tile
+            chunk.quads.push_back(sprite->makeQuad(Vec3(x * tileWidth + tileWidth * 0.5f, y * tileHeight + tileHeight * 0.5f, 0.0f)));
+        }
+    }
+}
+
+u32 TileMap::render(RenderLayer *layer, const Camera& camera, Vec3 position, Vec4 color) {
+    if (chunks.empty()) {
+        return 0;
+    }
+
+    //    atlas builds, repacks and releases move sprites to other textures or UVs
+    if (spriteGeneration != Sprite::generation) {
+        invalidate();
+        spriteGeneration = Sprite::generation;
+    }
+
+    u32 firstX = 0, lastX = chunksX - 1;
+    u32 firstY = 0, lastY = chunksY - 1;
+
+    //    with an affine orthographic projection (like RenderLayer::cullBatch looks for) the view is
+    //    a rectangle, so only the chunks under it are needed. anything else gets the whole map
+    const Mat4& p = camera.projectionMatrix;
+    if (p.data2d[1][0] == 0.0f && p.data2d[2][0] == 0.0f && p.data2d[0][1] == 0.0f && p.data2d[2][1] == 0.0f &&
+        p.data2d[0][3] == 0.0f && p.data2d[1][3] == 0.0f && p.data2d[2][3] == 0.0f && p.data2d[3][3] == 1.0f &&
+        p.data2d[0][0] != 0.0f && p.data2d[1][1] != 0.0f) {
+
+        //    clip space [-1, 1] back to world space, then into map space
+        f32 x1 = (-1.0f - p.data2d[3][0]) / p.data2d[0][0] - position.x;
+        f32 x2 = (1.0f - p.data2d[3][0]) / p.data2d[0][0] - position.x;
+        f32 y1 = (-1.0f - p.data2d[3][1]) / p.data2d[1][1] - position.y;
+        f32 y2 = (1.0f - p.data2d[3][1]) / p.data2d[1][1] - position.y;
+        if (x1 > x2) {
+            std::swap(x1, x2);
+        }
+        if (y1 > y2) {
+            std::swap(y1, y2);
+        }
+
+        //    a tile's sprite can hang over its neighbours, so keep a tile's margin
+        f32 chunkWidth = (f32)(tileWidth * CHUNK_SIZE);
+        f32 chunkHeight = (f32)(tileHeight * CHUNK_SIZE);
+        f32 left = floorf((x1 - tileWidth) / chunkWidth);
+        f32 right = floorf((x2 + tileWidth) / chunkWidth);
+        f32 top = floorf((y1 - tileHeight) / chunkHeight);
+        f32 bottom = floorf((y2 + tileHeight) / chunkHeight);
+
+        if (right < 0.0f || bottom < 0.0f || left >= (f32)chunksX || top >= (f32)chunksY) {
+            return 0;
+        }
+        firstX = (u32)max(left, 0.0f);
+        firstY = (u32)max(top, 0.0f);
+        lastX = (u32)min(right, (f32)(chunksX - 1));
+        lastY = (u32)min(bottom, (f32)(chunksY - 1));
+    }
+
+    u32 queued = 0;
+    for (u32 chunkY = firstY; chunkY <= lastY; chunkY++) {
+        for (u32 chunkX = firstX; chunkX <= lastX; chunkX++) {
+            Chunk& chunk = chunks[chunkY * chunksX + chunkX];
+            if (chunk.dirty) {
+                buildChunk(chunkX, chunkY);
+            }
+            if (chunk.quads.empty()) {
+                continue;
+            }
+
+            layer->renderQuads(&chunk.quads[0], chunk.quads.size(), position, color);
+            queued += chunk.quads.size();
+        }
+    }
+
+    //    tiles uploaded while building don't need another rebuild
+    spriteGeneration = Sprite::generation;
+
+    return queued;
+}
+
+}   //  namespace
@@ -0,0 +1,81 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#ifndef AB_TILE_MAP_H
+#define AB_TILE_MAP_H
+
+#include "renderLayer.h"
+
+namespace AB {
+
+//  A grid of sprites. Tiles are sprite indices, 0 for none, kept in one flat array. The map is
+//  split into CHUNK_SIZE x CHUNK_SIZE chunks whose quads are built once and only rebuilt when a
+//  tile in them changes, and rendering copies just the chunks in view into a layer's batch.
+class TileMap {
+    public:
+        static const u32 CHUNK_SIZE = 16;
+
+        TileMap(u32 width, u32 height, u32 tileWidth, u32 tileHeight);
+        ~TileMap() {}
+
+        u16 getTile(u32 x, u32 y) const { return tiles[y * width + x]; }
+        void setTile(u32 x, u32 y, u16 tile);
+
+        //    copies a w x h block of tiles in or out, row by row. clipped to the map
+        void setTiles(u32 x, u32 y, u32 w, u32 h, const u16* source);
+        void getTiles(u32 x, u32 y, u32 w, u32 h, u16* destination) const;
+        void fill(u32 x, u32 y, u32 w, u32 h, u16 tile);
+
+        //    marks every chunk for rebuilding. render() does this itself when any sprite's texture
+        //    or UVs have changed since (see Sprite::generation)
+        void invalidate();
+
+        //    queues the chunks that overlap the camera's view with the map's top left corner at
+        //    position. returns how many tiles were queued
+        u32 render(RenderLayer *layer, const Camera& camera, Vec3 position, Vec4 color = Vec4(1.0f, 1.0f, 1.0f, 1.0f));
+
+        u32 getWidth() const { return width; }
+        u32 getHeight() const { return height; }
+
+    private:
+        struct Chunk {
+            std::vector<RenderLayer::Quad> quads;   //    relative to the map's corner, z = 0
+            b8 dirty;
+        };
+
+        void markDirty(u32 x, u32 y, u32 w, u32 h);
+        void buildChunk(u32 chunkX, u32 chunkY);
+
+        u32 width, height;
+        u32 tileWidth, tileHeight;
+        u32 chunksX, chunksY;
+
+        std::vector<u16> tiles;
+        std::vector<Chunk> chunks;
+        u32 spriteGeneration;
+};
+
+}   //  namespace
+
+#endif
@@ -85,7 +85,8 @@ static int luaPrintString(lua_State* luaVM) {
     float y = (float)lua_tonumber(luaVM, 4);
     float scale = (float)lua_tonumber(luaVM, 5);
     int alignment = (int)lua_tonumber(luaVM, 6);
-    std::string str = std::string(lua_tostring(luaVM, 7));
+    size_t length;
+    const char* str = lua_tolstring(luaVM, 7, &length);
 /*
     //  adjust to match love2d font metrics
     scale /= 36.0f;
@@ -102,7 +103,7 @@ static int luaPrintString(lua_State* luaVM) {
 
     RenderLayer *batchRenderer = reinterpret_cast<RenderLayer*>(renderer.layers[layer]);
 
-    fonts.get(fontIndex)->printString(batchRenderer, x, y, scale, align, str);
+    fonts.get(fontIndex)->printString(batchRenderer, x, y, scale, align, str, length);
 
     return 0;
 }
@@ -115,13 +116,14 @@ static int luaPrintString(lua_State* luaVM) {
 // @function AB.font.stringLength
 static int luaStringLength(lua_State* luaVM) {
     int fontIndex = (int)lua_tonumber(luaVM, 1);
-    std::string str = std::string(lua_tostring(luaVM, 2));
+    size_t length;
+    const char* str = lua_tolstring(luaVM, 2, &length);
     float scale = (float)lua_tonumber(luaVM, 3);
 
     //    why
     // scale /= 36.0f;
 
-    lua_pushnumber(luaVM, fonts.get(fontIndex)->stringLength(str, scale));
+    lua_pushnumber(luaVM, fonts.get(fontIndex)->stringLength(str, length, scale));
 
     return 1;
 }
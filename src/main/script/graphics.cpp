@@ -31,8 +31,11 @@ Graphics state and rendering
 #include "script.h"
 #include "../core/window.h"
 #include "../renderer/spriteAtlas.h"
+#include "../renderer/textureArray.h"
 #include "../renderer/renderTarget.h"
 #include "../renderer/renderer.h"
+#include "../renderer/staticLayer.h"
+#include "../renderer/tileMap.h"
 
 namespace AB {
 
@@ -50,6 +53,8 @@ static Vec4 currentColor = Vec4(1.0f, 1.0f, 1.0f, 1.0f);
 static u32 spriteHandle = 1;
 static u32 canvasHandle = 1;
 static u32 currentRenderTarget = 0;
+static u32 tileMapHandle = 1;
+static std::map<u32, TileMap*> tileMaps;
 
 /// Color transforms
 // @field NONE ()
@@ -117,7 +122,7 @@ static i32 luaClear(lua_State* luaVM) {
     if (lua_gettop(luaVM) >= 4) {
         a = (f32)lua_tonumber(luaVM, 4);
     }
-    renderer.clear(r, g, b, a);
+    renderer.queueClear(r, g, b, a);
     
     return 0;
 }
@@ -192,6 +197,49 @@ static i32 luaLoadAtlas(lua_State* luaVM) {
     return 2;
 }
 
+/// Loads a sprite atlas packed by the asset compiler. Every image in a directory named *.atlas is trimmed and packed
+// into as few texture pages as possible when the archive is built, so loading one costs nothing beyond the page uploads.
+// Trimmed sprites still draw where they would untrimmed, but AB.graphics.spriteSize returns the trimmed size.
+// Before the archive is built the directory's images are loaded from disk into the shared atlas, untrimmed.
+// @function AB.graphics.loadPackedAtlas
+// @param filename Atlas directory name, ie "sprites/ui.atlas"
+// @param collisionMask (false) If collision masks should be created
+// @param index (optional) First sprite index
+// @return first sprite handle
+// @return number of sprites loaded
+// @return table of sprite handles keyed by image name, ie handles["buttons/ok"]
+static i32 luaLoadPackedAtlas(lua_State* luaVM) {
+    std::string filename = std::string(lua_tostring(luaVM, 1));
+
+    b8 createMask = false;
+    if (lua_gettop(luaVM) >= 2) {
+        createMask = (b8)lua_toboolean(luaVM, 2);
+    }
+
+    i32 index;
+    i32 spritesLoaded;
+    std::vector<std::string> names;
+    if (lua_gettop(luaVM) >= 3) {
+        index = (i32)lua_tonumber(luaVM, 3);
+        spritesLoaded = loadPackedAtlas(filename, index, names, createMask);
+    } else {
+        index = spriteHandle;
+        spritesLoaded = loadPackedAtlas(filename, index, names, createMask);
+        spriteHandle += spritesLoaded;
+    }
+
+    lua_pushnumber(luaVM, index);
+    lua_pushnumber(luaVM, spritesLoaded);
+
+    lua_createtable(luaVM, 0, names.size());
+    for (u32 i = 0; i < names.size(); i++) {
+        lua_pushnumber(luaVM, index + i);
+        lua_setfield(luaVM, -2, names[i].c_str());
+    }
+
+    return 3;
+}
+
 /// Adds a sprite into the current atlas queue. This should be done at startup before any rendering occurs. Sprites that are commonly
 // used together can be batched into a single atlas to improve performance by minimizing texture switches.
 // @param index Sprite index
@@ -203,7 +251,8 @@ static i32 luaAddToAtlas(lua_State* luaVM) {
     return 0;
 }
 
-/// Builds a sprite atlas. Call this after several calls to AB.graphics.addToAtlas
+/// Builds a sprite atlas. Call this after several calls to AB.graphics.addToAtlas. It can be called again later for
+// sprites made at runtime, which are packed in around the ones already there
 // @function AB.graphics.buildAtlas
 static i32 luaBuildAtlas(lua_State* luaVM) {
     buildAtlas();
@@ -211,6 +260,35 @@ static i32 luaBuildAtlas(lua_State* luaVM) {
     return 0;
 }
 
+/// Takes a sprite back out of the atlas, freeing its space for others. It goes back to its own texture
+// @param index Sprite index
+// @function AB.graphics.removeFromAtlas
+static i32 luaRemoveFromAtlas(lua_State* luaVM) {
+    i32 index = (i32)lua_tonumber(luaVM, 1);
+    removeFromAtlas(sprites.get(index));
+
+    return 0;
+}
+
+/// Queues a sprite's texture page to be copied into a texture array. Like AB.graphics.addToAtlas this should be done
+// at startup. Layers created with texture arrays enabled can then draw every page of the same size with one texture unit.
+// @param index Sprite index
+// @function AB.graphics.addToTextureArray
+static i32 luaAddToTextureArray(lua_State* luaVM) {
+    i32 index = (i32)lua_tonumber(luaVM, 1);
+    addToTextureArray(sprites.get(index));
+
+    return 0;
+}
+
+/// Builds texture arrays. Call this after several calls to AB.graphics.addToTextureArray
+// @function AB.graphics.buildTextureArrays
+static i32 luaBuildTextureArrays(lua_State* luaVM) {
+    buildTextureArrays();
+
+    return 0;
+}
+
 /// Defines a sprite from an atlas texture
 // @function AB.graphics.defineSpriteFromAtlas
 // @param atlasIndex Sprite atlas index
@@ -549,10 +627,8 @@ static i32 luaCreateCanvas(lua_State* luaVM) {
 static i32 luaDeleteCanvas(lua_State* luaVM) {
     u32 index = (u32)lua_tonumber(luaVM, 1);
 
-    std::map<u32, AB::RenderTarget*>::iterator it;
-    it = renderer.canvases.find(index);
-    delete renderer.canvases[index];
-    renderer.canvases.erase(it);
+    //  draws already recorded to it this frame still happen
+    renderer.deleteCanvas(index);
 
     return 0;
 }
@@ -563,18 +639,14 @@ static i32 luaDeleteCanvas(lua_State* luaVM) {
 static i32 luaUseCanvas(lua_State* luaVM) {
     u32 index = (u32)lua_tonumber(luaVM, 1);
 
-    renderer.render(camera2d);
-    
-    if (currentRenderTarget != 0) {
-        renderer.canvases[currentRenderTarget]->end();
-    }
+    //    recorded rather than bound, the switch happens when the frame's render queue runs
+    renderer.setTarget(index, camera2d);
     
     currentRenderTarget = index;
     if (currentRenderTarget != 0) {
         if (renderer.canvases.find(currentRenderTarget) == renderer.canvases.end()) {
             ERR("Render target not created: %d", currentRenderTarget);
         }
-        renderer.canvases[currentRenderTarget]->begin();
 
         //    TODO: not sure about setting the projection this way.. (y coords are flipped)
         camera2d.setProjection(0, renderer.canvases[currentRenderTarget]->width, 0, renderer.canvases[currentRenderTarget]->height);
@@ -644,6 +716,9 @@ static i32 luaRenderCanvas(lua_State* luaVM) {
 // @function AB.graphics.createLayer
 // @param index Layer index
 // @param depthSorting (false) Whether this layer needs to support depth sorting
+// @param textureArrays (false) Whether this layer draws sprites from texture arrays (see AB.graphics.buildTextureArrays)
+// @param packed (false) Whether to upload compact 32 byte sprite instances. Halves bandwidth on busy layers, at the cost of
+// half float sizes, texture coordinates clamped to [0, 1] and 8 bit color
 // @return layer index
 static i32 luaCreateLayer(lua_State* luaVM) {
     u32 index = (u32)lua_tonumber(luaVM, 1);
@@ -651,13 +726,49 @@ static i32 luaCreateLayer(lua_State* luaVM) {
     if (lua_gettop(luaVM) >= 2) {
         depthSorting = (b8)lua_toboolean(luaVM, 2);
     }
-    renderer.layers[index] = new RenderLayer(nullptr, nullptr, blend::identity(), depthSorting);
+    b8 textureArrays = false;
+    if (lua_gettop(luaVM) >= 3) {
+        textureArrays = (b8)lua_toboolean(luaVM, 3);
+    }
+    b8 packed = false;
+    if (lua_gettop(luaVM) >= 4) {
+        packed = (b8)lua_toboolean(luaVM, 4);
+    }
+    renderer.layers[index] = new RenderLayer(nullptr, nullptr, blend::identity(), depthSorting, textureArrays, packed);
 
     lua_pushnumber(luaVM, index);
 
     return 1;
 }
 
+/// Turns view culling on or off for a layer. Culling is on by default, dropping sprites that fall outside the
+// view before they're sorted and uploaded. Turn it off for layers drawn with batch shaders that move sprites
+// @function AB.graphics.setLayerCulling
+// @param index Layer index
+// @param enabled Whether to cull
+static i32 luaSetLayerCulling(lua_State* luaVM) {
+    u32 index = (u32)lua_tonumber(luaVM, 1);
+    b8 enabled = (b8)lua_toboolean(luaVM, 2);
+
+    renderer.layers[index]->culling = enabled;
+
+    return 0;
+}
+
+/// Turns batch sorting on or off for a layer. Sorting is on by default, grouping sprites by texture (and depth
+// for depth sorted layers). Turn it off for layers that are only fed sprites already in draw order, like particle systems
+// @function AB.graphics.setLayerSorting
+// @param index Layer index
+// @param enabled Whether to sort
+static i32 luaSetLayerSorting(lua_State* luaVM) {
+    u32 index = (u32)lua_tonumber(luaVM, 1);
+    b8 enabled = (b8)lua_toboolean(luaVM, 2);
+
+    renderer.layers[index]->sorting = enabled;
+
+    return 0;
+}
+
 ///    Removes a rendering layer
 // @function AB.graphics.removeLayer
 // @param index Layer index
@@ -670,6 +781,331 @@ static i32 luaRemoveLayer(lua_State* luaVM) {
     return 0;
 }
 
+/// Creates a static layer. Sprites and quads drawn to it between AB.graphics.beginStaticLayer and
+// AB.graphics.endStaticLayer are kept on the GPU and redrawn every frame without being resubmitted, for
+// backgrounds, tile layers and the like. Anything else drawn to the layer is drawn on top as usual
+// @function AB.graphics.createStaticLayer
+// @param index Layer index
+// @param depthSorting (false) Whether this layer needs to support depth sorting
+// @param textureArrays (false) Whether this layer draws sprites from texture arrays
+// @param packed (false) Whether to store compact 32 byte sprite instances
+// @return layer index
+static i32 luaCreateStaticLayer(lua_State* luaVM) {
+    u32 index = (u32)lua_tonumber(luaVM, 1);
+    b8 depthSorting = false;
+    if (lua_gettop(luaVM) >= 2) {
+        depthSorting = (b8)lua_toboolean(luaVM, 2);
+    }
+    b8 textureArrays = false;
+    if (lua_gettop(luaVM) >= 3) {
+        textureArrays = (b8)lua_toboolean(luaVM, 3);
+    }
+    b8 packed = false;
+    if (lua_gettop(luaVM) >= 4) {
+        packed = (b8)lua_toboolean(luaVM, 4);
+    }
+    renderer.layers[index] = new StaticLayer(nullptr, blend::identity(), depthSorting, textureArrays, packed);
+
+    lua_pushnumber(luaVM, index);
+
+    return 1;
+}
+
+static StaticLayer* getStaticLayer(u32 index) {
+    auto iterator = renderer.layers.find(index);
+    StaticLayer *layer = iterator == renderer.layers.end() ? nullptr : dynamic_cast<StaticLayer*>(iterator->second);
+    if (!layer) {
+        ERR("Layer %d is not a static layer", index);
+    }
+    return layer;
+}
+
+/// Starts recording a static layer, replacing what it held before
+// @function AB.graphics.beginStaticLayer
+// @param index Layer index
+static i32 luaBeginStaticLayer(lua_State* luaVM) {
+    u32 index = (u32)lua_tonumber(luaVM, 1);
+
+    StaticLayer *layer = getStaticLayer(index);
+    if (layer) {
+        layer->beginStatic();
+    }
+
+    return 0;
+}
+
+/// Starts overwriting part of a static layer. What's drawn until AB.graphics.endStaticLayer replaces the
+// layer's sprites in the order they were first drawn, starting at first. Only the changed range is uploaded
+// as long as every sprite keeps its texture
+// @function AB.graphics.updateStaticLayer
+// @param index Layer index
+// @param first (1) First sprite to overwrite
+static i32 luaUpdateStaticLayer(lua_State* luaVM) {
+    u32 index = (u32)lua_tonumber(luaVM, 1);
+    u32 first = 1;
+    if (lua_gettop(luaVM) >= 2) {
+        first = (u32)lua_tonumber(luaVM, 2);
+    }
+
+    StaticLayer *layer = getStaticLayer(index);
+    if (layer) {
+        layer->beginUpdate(first > 0 ? first - 1 : 0);
+    }
+
+    return 0;
+}
+
+/// Finishes a static layer recording or update and uploads it
+// @function AB.graphics.endStaticLayer
+// @param index Layer index
+// @return number of sprites held by the layer
+static i32 luaEndStaticLayer(lua_State* luaVM) {
+    u32 index = (u32)lua_tonumber(luaVM, 1);
+
+    StaticLayer *layer = getStaticLayer(index);
+    lua_pushnumber(luaVM, layer ? layer->endStatic() : 0);
+
+    return 1;
+}
+
+/// Offsets everything recorded in a static layer, for scrolling
+// @function AB.graphics.setStaticLayerOffset
+// @param index Layer index
+// @param x X offset
+// @param y Y offset
+static i32 luaSetStaticLayerOffset(lua_State* luaVM) {
+    u32 index = (u32)lua_tonumber(luaVM, 1);
+    f32 x = (f32)lua_tonumber(luaVM, 2);
+    f32 y = (f32)lua_tonumber(luaVM, 3);
+
+    StaticLayer *layer = getStaticLayer(index);
+    if (layer) {
+        layer->offset = Vec2(x, y);
+    }
+
+    return 0;
+}
+
+/// Creates a tile map. Tiles are sprite indices, 0 for an empty tile. Tiles are drawn in chunks that are
+// only rebuilt when a tile in them changes, and only chunks in view are drawn, so a large map costs little
+// more than the part of it on screen. Tile coordinates start at 1
+// @function AB.graphics.createTileMap
+// @param width Width in tiles
+// @param height Height in tiles
+// @param tileWidth Width of a tile in pixels
+// @param tileHeight (tileWidth) Height of a tile in pixels
+// @param index (optional) Tile map handle
+// @return tile map handle
+static i32 luaCreateTileMap(lua_State* luaVM) {
+    u32 width = (u32)lua_tonumber(luaVM, 1);
+    u32 height = (u32)lua_tonumber(luaVM, 2);
+    u32 tileWidth = (u32)lua_tonumber(luaVM, 3);
+    u32 tileHeight = tileWidth;
+    if (lua_gettop(luaVM) >= 4) {
+        tileHeight = (u32)lua_tonumber(luaVM, 4);
+    }
+
+    u32 index;
+    if (lua_gettop(luaVM) >= 5) {
+        index = (u32)lua_tonumber(luaVM, 5);
+    } else {
+        index = tileMapHandle;
+        tileMapHandle++;
+    }
+
+    auto iterator = tileMaps.find(index);
+    if (iterator != tileMaps.end()) {
+        delete iterator->second;
+    }
+    tileMaps[index] = new TileMap(width, height, tileWidth, tileHeight);
+
+    lua_pushnumber(luaVM, index);
+
+    return 1;
+}
+
+static TileMap* getTileMap(u32 index) {
+    auto iterator = tileMaps.find(index);
+    if (iterator == tileMaps.end()) {
+        ERR("Tile map not created: %d", index);
+        return nullptr;
+    }
+    return iterator->second;
+}
+
+/// Deletes a tile map
+// @function AB.graphics.deleteTileMap
+// @param index Tile map handle
+static i32 luaDeleteTileMap(lua_State* luaVM) {
+    u32 index = (u32)lua_tonumber(luaVM, 1);
+
+    auto iterator = tileMaps.find(index);
+    if (iterator != tileMaps.end()) {
+        delete iterator->second;
+        tileMaps.erase(iterator);
+    }
+
+    return 0;
+}
+
+/// Sets a single tile
+// @function AB.graphics.setTile
+// @param index Tile map handle
+// @param x X (1 based)
+// @param y Y (1 based)
+// @param tile Sprite index, or 0 to clear
+static i32 luaSetTile(lua_State* luaVM) {
+    u32 index = (u32)lua_tonumber(luaVM, 1);
+    i32 x = (i32)lua_tonumber(luaVM, 2);
+    i32 y = (i32)lua_tonumber(luaVM, 3);
+    u16 tile = (u16)lua_tonumber(luaVM, 4);
+
+    TileMap *tileMap = getTileMap(index);
+    if (tileMap && x >= 1 && y >= 1) {
+        tileMap->setTile(x - 1, y - 1, tile);
+    }
+
+    return 0;
+}
+
+/// Gets a single tile
+// @function AB.graphics.getTile
+// @param index Tile map handle
+// @param x X (1 based)
+// @param y Y (1 based)
+// @return sprite index, 0 for empty or outside the map
+static i32 luaGetTile(lua_State* luaVM) {
+    u32 index = (u32)lua_tonumber(luaVM, 1);
+    i32 x = (i32)lua_tonumber(luaVM, 2);
+    i32 y = (i32)lua_tonumber(luaVM, 3);
+
+    TileMap *tileMap = getTileMap(index);
+    u16 tile = 0;
+    if (tileMap && x >= 1 && y >= 1 && (u32)x <= tileMap->getWidth() && (u32)y <= tileMap->getHeight()) {
+        tile = tileMap->getTile(x - 1, y - 1);
+    }
+    lua_pushnumber(luaVM, tile);
+
+    return 1;
+}
+
+/// Sets a block of tiles from a flat table, row by row. Parts outside the map are ignored
+// @function AB.graphics.setTiles
+// @param index Tile map handle
+// @param x Left (1 based)
+// @param y Top (1 based)
+// @param width Width of the block in tiles
+// @param tiles Sprite indices, width per row
+// @usage AB.graphics.setTiles(map, 1, 1, 3, { 1, 2, 1, 4, 0, 4 })
+static i32 luaSetTiles(lua_State* luaVM) {
+    u32 index = (u32)lua_tonumber(luaVM, 1);
+    i32 x = (i32)lua_tonumber(luaVM, 2);
+    i32 y = (i32)lua_tonumber(luaVM, 3);
+    u32 width = (u32)lua_tonumber(luaVM, 4);
+
+    TileMap *tileMap = getTileMap(index);
+    if (!tileMap || width == 0 || x < 1 || y < 1) {
+        return 0;
+    }
+
+    u32 count = lua_rawlen(luaVM, 5);
+    u32 height = (count + width - 1) / width;
+
+    std::vector<u16> block(width * height, 0);
+    for (u32 i = 0; i < count; i++) {
+        lua_rawgeti(luaVM, 5, i + 1);
+        block[i] = (u16)lua_tonumber(luaVM, -1);
+        lua_pop(luaVM, 1);
+    }
+    tileMap->setTiles(x - 1, y - 1, width, height, &block[0]);
+
+    return 0;
+}
+
+/// Gets a block of tiles as a flat table, row by row. Tiles outside the map come back as 0
+// @function AB.graphics.getTiles
+// @param index Tile map handle
+// @param x Left (1 based)
+// @param y Top (1 based)
+// @param width Width of the block in tiles
+// @param height Height of the block in tiles
+// @return table of sprite indices
+static i32 luaGetTiles(lua_State* luaVM) {
+    u32 index = (u32)lua_tonumber(luaVM, 1);
+    i32 x = (i32)lua_tonumber(luaVM, 2);
+    i32 y = (i32)lua_tonumber(luaVM, 3);
+    u32 width = (u32)lua_tonumber(luaVM, 4);
+    u32 height = (u32)lua_tonumber(luaVM, 5);
+
+    TileMap *tileMap = getTileMap(index);
+
+    u32 count = width * height;
+    std::vector<u16> block(count, 0);
+    if (tileMap && count > 0 && x >= 1 && y >= 1) {
+        tileMap->getTiles(x - 1, y - 1, width, height, &block[0]);
+    }
+
+    lua_createtable(luaVM, count, 0);
+    for (u32 i = 0; i < count; i++) {
+        lua_pushnumber(luaVM, block[i]);
+        lua_rawseti(luaVM, -2, i + 1);
+    }
+
+    return 1;
+}
+
+/// Fills a rectangle of tiles with one sprite
+// @function AB.graphics.fillTiles
+// @param index Tile map handle
+// @param x Left (1 based)
+// @param y Top (1 based)
+// @param width Width in tiles
+// @param height Height in tiles
+// @param tile Sprite index, or 0 to clear
+static i32 luaFillTiles(lua_State* luaVM) {
+    u32 index = (u32)lua_tonumber(luaVM, 1);
+    i32 x = (i32)lua_tonumber(luaVM, 2);
+    i32 y = (i32)lua_tonumber(luaVM, 3);
+    u32 width = (u32)lua_tonumber(luaVM, 4);
+    u32 height = (u32)lua_tonumber(luaVM, 5);
+    u16 tile = (u16)lua_tonumber(luaVM, 6);
+
+    TileMap *tileMap = getTileMap(index);
+    if (tileMap && x >= 1 && y >= 1) {
+        tileMap->fill(x - 1, y - 1, width, height, tile);
+    }
+
+    return 0;
+}
+
+/// Queues the visible part of a tile map, tinted with the current color
+// @function AB.graphics.renderTileMap
+// @param layer Rendering layer
+// @param index Tile map handle
+// @param x X position of the map's top left corner
+// @param y Y position of the map's top left corner
+// @param z (-1) Z position
+// @return number of tiles queued
+static i32 luaRenderTileMap(lua_State* luaVM) {
+    u32 layer = (u32)lua_tonumber(luaVM, 1);
+    u32 index = (u32)lua_tonumber(luaVM, 2);
+    f32 x = floor((f32)lua_tonumber(luaVM, 3) + 0.5f);
+    f32 y = floor((f32)lua_tonumber(luaVM, 4) + 0.5f);
+    f32 z = -1.0f;
+    if (lua_gettop(luaVM) >= 5) {
+        z = (f32)lua_tonumber(luaVM, 5);
+    }
+
+    TileMap *tileMap = getTileMap(index);
+    u32 queued = 0;
+    if (tileMap) {
+        queued = tileMap->render(renderer.layers[layer], camera2d, Vec3(x, y, z), currentColor);
+    }
+    lua_pushnumber(luaVM, queued);
+
+    return 1;
+}
+
 /// Adds a color transform for layer. Chained with any previous color transforms
 // @function AB.graphics.addColorTransform
 // @param index Layer index
@@ -817,6 +1253,38 @@ static i32 luaFlushGraphics(lua_State* luaVM) {
     return 0;
 }
 
+/// Gets the state churn of the last rendered frame. Skips are state changes and uniform uploads that matched
+// what was already set and never reached the driver
+// @function AB.graphics.getRenderStats
+// @return table with drawCalls, culledQuads, programBinds, programSkips, vertexArrayBinds, vertexArraySkips, framebufferBinds,
+// framebufferSkips, blendChanges, blendSkips, uniformUploads and uniformSkips
+static i32 luaGetRenderStats(lua_State* luaVM) {
+    const RenderState::Stats& stats = renderer.getFrameStats();
+
+    const std::pair<const char*, u32> fields[] = {
+        { "drawCalls", stats.drawCalls },
+        { "culledQuads", stats.culledQuads },
+        { "programBinds", stats.programBinds },
+        { "programSkips", stats.programSkips },
+        { "vertexArrayBinds", stats.vertexArrayBinds },
+        { "vertexArraySkips", stats.vertexArraySkips },
+        { "framebufferBinds", stats.framebufferBinds },
+        { "framebufferSkips", stats.framebufferSkips },
+        { "blendChanges", stats.blendChanges },
+        { "blendSkips", stats.blendSkips },
+        { "uniformUploads", stats.uniformUploads },
+        { "uniformSkips", stats.uniformSkips },
+    };
+
+    lua_newtable(luaVM);
+    for (auto& field : fields) {
+        lua_pushnumber(luaVM, field.second);
+        lua_setfield(luaVM, -2, field.first);
+    }
+
+    return 1;
+}
+
 void registerGraphicsFunctions() {
     static const luaL_Reg graphicsFuncs[] = {
         { "resetVideo", luaResetVideo},
@@ -825,8 +1293,12 @@ void registerGraphicsFunctions() {
             
         { "loadSprite", luaLoadSprite},
         { "loadAtlas", luaLoadAtlas},
+        { "loadPackedAtlas", luaLoadPackedAtlas},
         { "addToAtlas", luaAddToAtlas},
         { "buildAtlas", luaBuildAtlas},
+        { "removeFromAtlas", luaRemoveFromAtlas},
+        { "addToTextureArray", luaAddToTextureArray},
+        { "buildTextureArrays", luaBuildTextureArrays},
         { "defineSpriteFromAtlas", luaDefineSpriteFromAtlas},
 
         { "renderSprite", luaRenderSprite},
@@ -846,6 +1318,22 @@ void registerGraphicsFunctions() {
 
         { "createLayer", luaCreateLayer},
         { "removeLayer", luaRemoveLayer},
+        { "setLayerCulling", luaSetLayerCulling},
+        { "setLayerSorting", luaSetLayerSorting},
+        { "createStaticLayer", luaCreateStaticLayer},
+        { "beginStaticLayer", luaBeginStaticLayer},
+        { "updateStaticLayer", luaUpdateStaticLayer},
+        { "endStaticLayer", luaEndStaticLayer},
+        { "setStaticLayerOffset", luaSetStaticLayerOffset},
+
+        { "createTileMap", luaCreateTileMap},
+        { "deleteTileMap", luaDeleteTileMap},
+        { "setTile", luaSetTile},
+        { "getTile", luaGetTile},
+        { "setTiles", luaSetTiles},
+        { "getTiles", luaGetTiles},
+        { "fillTiles", luaFillTiles},
+        { "renderTileMap", luaRenderTileMap},
         
         { "addColorTransform", luaAddColorTransform},
         { "resetColorTransforms", luaResetColorTransforms},
@@ -855,6 +1343,7 @@ void registerGraphicsFunctions() {
         { "setBatchShader", luaSetBatchShader},
         
         { "flushGraphics", luaFlushGraphics},
+        { "getRenderStats", luaGetRenderStats},
         
         { NULL, NULL }
     };
@@ -44,6 +44,10 @@ freely, subject to the following restrictions:
 #include "../../main/input/input.h"
 #include "../../main/misc/misc.h"
 #include "../../main/core/window.h"
+#include "../../main/renderer/renderThread.h"
+
+#include "replay.h"
+#include "soak.h"
 
 #ifdef DEBUG
 #include "capture.h"
@@ -132,73 +136,158 @@ void setFrameRate(f32 const newRate) {
     //frameRate = newRate;
 }
 
-void mainLoop(Application *app) {
-    // process events
-    SDL_Event event;
+void parseCommandLine(int argc, char* argv[]) {
+    f64 soakDuration = 0.0;
+    f64 soakInterval = 10.0;
 
-    while (SDL_PollEvent(&event) != 0) {
-        eventQueue.push_back(event);
-        if (event.type == SDL_QUIT) {
-            done = true;
-        }
+    for (i32 i = 1; i < argc - 1; i++) {
+        std::string arg = argv[i];
 
-        //  call onPause / onResume on focus events
-        if (event.type == SDL_WINDOWEVENT) {
-            if (event.window.event == SDL_WINDOWEVENT_FOCUS_GAINED) {
-                audio.resumeAll();
-                app->onResume();
+        if (arg == "--record") {
+            if (!beginRecording(argv[++i])) {
+                exit(EXIT_FAILURE);
             }
-            if (event.window.event == SDL_WINDOWEVENT_FOCUS_LOST) {
-                audio.pauseAll();
-                app->onPause();
+        } else if (arg == "--replay") {
+            if (!beginReplay(argv[++i])) {
+                exit(EXIT_FAILURE);
             }
+        } else if (arg == "--soak") {
+            soakDuration = atof(argv[++i]);
+        } else if (arg == "--soak-interval") {
+            soakInterval = atof(argv[++i]);
         }
+    }
 
-        if (event.type == SDL_KEYDOWN) {
-            if (event.key.keysym.sym == SDLK_ESCAPE) {
-                app->onBackPressed();
-            }
+    if (soakDuration > 0.0) {
+        beginSoak(soakDuration, soakInterval);
+    }
+}
+
+static void dispatchEvent(Application *app, SDL_Event const& event) {
+    if (event.type == SDL_QUIT) {
+        done = true;
+    }
+
+    //  call onPause / onResume on focus events
+    if (event.type == SDL_WINDOWEVENT) {
+        if (event.window.event == SDL_WINDOWEVENT_FOCUS_GAINED) {
+            audio.resumeAll();
+            app->onResume();
+        }
+        if (event.window.event == SDL_WINDOWEVENT_FOCUS_LOST) {
+            audio.pauseAll();
+            app->onPause();
+        }
+    }
+
+    if (event.type == SDL_KEYDOWN) {
+        if (event.key.keysym.sym == SDLK_ESCAPE) {
+            app->onBackPressed();
+        }
 #ifdef DEBUG
-            if (event.key.keysym.sym == SDLK_PAUSE) {
-                debugPause = !debugPause;
-            }
+        if (event.key.keysym.sym == SDLK_PAUSE) {
+            debugPause = !debugPause;
+        }
 
-            if (event.key.keysym.sym == SDLK_F1) {
-                //  this is gross, but whatever
+        if (event.key.keysym.sym == SDLK_F1) {
+            //  this is gross, but whatever
 /*
-                int canvasWidth = graphics->canvasWidth;
-                int canvasHeight = graphics->canvasHeight;
-                int xRes = graphics->xRes;
-                int yRes = graphics->yRes;
-                bool fullscreen = graphics->fullscreen;
+            int canvasWidth = graphics->canvasWidth;
+            int canvasHeight = graphics->canvasHeight;
+            int xRes = graphics->xRes;
+            int yRes = graphics->yRes;
+            bool fullscreen = graphics->fullscreen;
 
-                script.shutdown();
-                script.startup();
+            script.shutdown();
+            script.startup();
 
-                app->glContextDestroyed();
-                app->glContextCreated(canvasWidth, canvasHeight, xRes, yRes, fullscreen);
-                script.execute("AB.init()");
+            app->glContextDestroyed();
+            app->glContextCreated(canvasWidth, canvasHeight, xRes, yRes, fullscreen);
+            script.execute("AB.init()");
 
-                graphics->invalidateTextureCache();
+            graphics->invalidateTextureCache();
 */
-            }
+        }
+#endif
+    }
+
+    if (event.type == SDL_MOUSEBUTTONDOWN) {
+        app->onPress(event.button.x, event.button.y);
+    }
+}
+
+static void fixedUpdate(Application *app) {
+#ifdef DEBUG
+    if (!console.active) {
+        PROFILE(APP UPDATE)
+
+        app->update();
+    }
+    input.update();
+    audio.update();
+    console.update();
+#else
+    app->update();
+    audio.update();
+    input.update();
 #endif
+    eventQueue.clear();
+}
+
+void mainLoop(Application *app) {
+    // process events
+    SDL_Event event;
+
+    //  events not yet consumed by an update carry over to the next frame
+    u32 firstNewEvent = eventQueue.size();
+    u32 updates = 0;
+
+    while (SDL_PollEvent(&event) != 0) {
+        if (replayingInput) {
+            //  live input is ignored during a replay, but let the user bail out
+            if (event.type == SDL_QUIT) {
+                done = true;
+            }
+            continue;
+        }
+
+        eventQueue.push_back(event);
+        dispatchEvent(app, event);
+    }
+
+    if (replayingInput) {
+        if (!replayFrame(eventQueue, updates)) {
+            done = true;
+            return;
         }
 
-        if (event.type == SDL_MOUSEBUTTONDOWN) {
-            app->onPress(event.button.x, event.button.y);
+        for (u32 i = firstNewEvent; i < eventQueue.size(); i++) {
+            input.replayEvent(eventQueue[i]);
+            dispatchEvent(app, eventQueue[i]);
         }
     }
 
+    std::vector<SDL_Event> frameEvents;
+    if (recordingInput) {
+        frameEvents.assign(eventQueue.begin() + firstNewEvent, eventQueue.end());
+    }
+
     //  call client update function
+    if (replayingInput) {
+        //  run exactly as many updates as the recorded frame did
+        for (u32 i = 0; i < updates; i++) {
+            fixedUpdate(app);
+        }
+        checkReplaySync();
+    } else
 #ifdef DEBUG
     //  force simulated 30fps gameplay for video capture
     if (recording) {
-        app->update();
-        eventQueue.clear();
-        app->update();
-        input.update();
-        audio.update();
+        //  two updates per captured frame, counted so input recording stays in step
+        for (u32 i = 0; i < 2; i++) {
+            fixedUpdate(app);
+            updates++;
+        }
 
         currentTime = SDL_GetTicks();
         while (currentTime < lastTime + 30) {
@@ -273,26 +362,26 @@ void mainLoop(Application *app) {
 
         while (frameAccumulator >= desiredFrametime * updateMultiplicity) {
             for(i32 i = 0; i < updateMultiplicity; i++) {
-#ifdef DEBUG
-                if (!console.active) {
-                    PROFILE(APP UPDATE)
-
-                    app->update();
-                }
-                input.update();
-                audio.update();
-                console.update();
-#else
-                app->update();
-                audio.update();
-                input.update();
-#endif
-                eventQueue.clear();
+                fixedUpdate(app);
                 frameAccumulator -= desiredFrametime;
+                updates++;
             }
         }
     }
 
+    if (recordingInput) {
+        recordFrame(frameEvents, updates);
+    }
+
+#ifdef DEBUG
+    //  the console and video capture draw and read back on this thread
+    if (recording || console.active) {
+        renderThread.stop();
+    } else if (window.pipelined) {
+        renderThread.start();
+    }
+#endif // DEBUG
+
     // RenderLayer::textureCache.invalidate();
     PROFILE(APP RENDER)
     app->render();
@@ -307,10 +396,18 @@ void mainLoop(Application *app) {
     }
 #endif // DEBUG
 
-    window.present();
+    if (renderThread.running) {
+        renderThread.submitFrame();
+    } else {
+        window.present();
+    }
+
+    updateSoak();
 
     //  yield to other processes. sharing is caring.
-    SDL_Delay(1);
+    if (!replayingInput) {
+        SDL_Delay(1);
+    }
 }
 
 void fatalError(std::string const& message, std::string const& file, i32 line) {
@@ -336,16 +433,32 @@ i32 run(Application *app) {
 
             app->startup();
             script.execute("AB.init()");
+
+            if (window.pipelined) {
+                renderThread.start();
+            }
         }
 
         LOG("Entering main loop", 0);
         LOG(std::string(79, '-').c_str(), 0);
 
+        if (replayingInput) {
+            input.beginReplay();
+        }
+
         while (!AB::done) {
             PROFILE(MAIN LOOP)
             mainLoop(app);
         }
 
+        renderThread.stop();
+        endRecording();
+        endReplay();
+
+        if (!endSoak()) {
+            exitCode = EXIT_FAILURE;
+        }
+
         LOG("Shutting down engine", 0);
         LOG(std::string(79, '-').c_str(), 0);
 /*
@@ -0,0 +1,255 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#include "../../main/pch.h"
+
+#include "replay.h"
+#include "../../main/core/log.h"
+#include "../../main/core/window.h"
+#include "../../main/math/math.h"
+
+namespace AB {
+
+extern Window window;
+extern f64 updateRate;
+extern i32 updateMultiplicity;
+
+static const char TRACE_MAGIC[4] = {'A', 'B', 'R', '1'};
+
+struct TraceHeader {
+    char magic[4];
+    u32 eventSize;
+    u32 seed;
+    i32 updateMultiplicity;
+    f64 updateRate;
+};
+
+struct FrameHeader {
+    u32 frame;
+    u32 updates;
+    u32 numEvents;
+    u32 pad;
+    u64 prngState;
+};
+
+static FILE *traceFile = NULL;
+static u32 frame;
+static u64 expectedState;
+static b8 desynced;
+
+//  replay timing
+static u64 replayStart, lastFrameTime, worstFrameTime;
+
+b8 recordingInput = false;
+b8 replayingInput = false;
+
+//  only events that are plain data are safe to write out. drop events and user events carry
+//  pointers, and nothing in the engine reads them anyway
+static b8 isRecordable(SDL_Event const& event) {
+    switch (event.type) {
+        case SDL_QUIT:
+        case SDL_WINDOWEVENT:
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+        case SDL_TEXTEDITING:
+        case SDL_TEXTINPUT:
+        case SDL_MOUSEMOTION:
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+        case SDL_MOUSEWHEEL:
+        case SDL_JOYDEVICEADDED:
+        case SDL_JOYDEVICEREMOVED:
+        case SDL_CONTROLLERAXISMOTION:
+        case SDL_CONTROLLERBUTTONDOWN:
+        case SDL_CONTROLLERBUTTONUP:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+b8 beginRecording(std::string const& filename) {
+    traceFile = fopen(filename.c_str(), "wb");
+    if (!traceFile) {
+        printf("Couldn't open input trace for writing: %s\n", filename.c_str());
+        return false;
+    }
+
+    //  the global PRNG is seeded from the clock, so pick a seed and pin it for the session
+    u32 seed = (u32)time(NULL);
+    rndPinSeed(seed);
+
+    TraceHeader header;
+    memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header.eventSize = sizeof(SDL_Event);
+    header.seed = seed;
+    header.updateMultiplicity = updateMultiplicity;
+    header.updateRate = updateRate;
+    fwrite(&header, sizeof(TraceHeader), 1, traceFile);
+
+    frame = 0;
+    recordingInput = true;
+
+    LOG("Recording input trace to %s (seed %u)", filename.c_str(), seed);
+
+    return true;
+}
+
+void recordFrame(std::vector<SDL_Event> const& events, u32 updates) {
+    u32 numEvents = 0;
+    for (auto& event : events) {
+        if (isRecordable(event)) {
+            numEvents++;
+        }
+    }
+
+    FrameHeader frameHeader;
+    frameHeader.frame = frame++;
+    frameHeader.updates = updates;
+    frameHeader.numEvents = numEvents;
+    frameHeader.pad = 0;
+    frameHeader.prngState = rndState();
+    fwrite(&frameHeader, sizeof(FrameHeader), 1, traceFile);
+
+    for (auto& event : events) {
+        if (isRecordable(event)) {
+            fwrite(&event, sizeof(SDL_Event), 1, traceFile);
+        }
+    }
+}
+
+void endRecording() {
+    if (!recordingInput) {
+        return;
+    }
+
+    fclose(traceFile);
+    traceFile = NULL;
+    recordingInput = false;
+
+    LOG("Recorded %d frames of input", frame);
+}
+
+b8 beginReplay(std::string const& filename) {
+    traceFile = fopen(filename.c_str(), "rb");
+    if (!traceFile) {
+        printf("Couldn't open input trace: %s\n", filename.c_str());
+        return false;
+    }
+
+    TraceHeader header;
+    if (fread(&header, sizeof(TraceHeader), 1, traceFile) != 1 ||
+        memcmp(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 ||
+        header.eventSize != sizeof(SDL_Event)) {
+
+        printf("Invalid input trace: %s\n", filename.c_str());
+        fclose(traceFile);
+        traceFile = NULL;
+        return false;
+    }
+
+    if (header.updateRate != updateRate || header.updateMultiplicity != updateMultiplicity) {
+        LOG("Input trace was recorded at %.1fHz x%d, replaying at %.1fHz x%d",
+            header.updateRate, header.updateMultiplicity, updateRate, updateMultiplicity);
+    }
+
+    rndPinSeed(header.seed);
+    window.headless = true;
+
+    frame = 0;
+    desynced = false;
+    worstFrameTime = 0;
+    replayStart = lastFrameTime = SDL_GetPerformanceCounter();
+    replayingInput = true;
+
+    LOG("Replaying input trace %s (seed %u)", filename.c_str(), header.seed);
+
+    return true;
+}
+
+b8 replayFrame(std::vector<SDL_Event>& events, u32& updates) {
+    u64 now = SDL_GetPerformanceCounter();
+    if (frame > 0) {
+        worstFrameTime = max(worstFrameTime, now - lastFrameTime);
+    }
+    lastFrameTime = now;
+
+    FrameHeader frameHeader;
+    if (fread(&frameHeader, sizeof(FrameHeader), 1, traceFile) != 1) {
+        return false;
+    }
+
+    if (frameHeader.frame != frame) {
+        printf("Input trace is corrupt at frame %d\n", frame);
+        return false;
+    }
+
+    for (u32 i = 0; i < frameHeader.numEvents; i++) {
+        SDL_Event event;
+        if (fread(&event, sizeof(SDL_Event), 1, traceFile) != 1) {
+            printf("Input trace is truncated at frame %d\n", frame);
+            return false;
+        }
+        events.push_back(event);
+    }
+
+    updates = frameHeader.updates;
+    expectedState = frameHeader.prngState;
+    frame++;
+
+    return true;
+}
+
+void checkReplaySync() {
+    //  the PRNG state is a cheap proxy for the simulation. if it drifts, the game read
+    //  something that wasn't in the trace
+    if (!desynced && rndState() != expectedState) {
+        printf("Input replay desynced at frame %d\n", frame - 1);
+        desynced = true;
+    }
+}
+
+void endReplay() {
+    if (!replayingInput) {
+        return;
+    }
+
+    fclose(traceFile);
+    traceFile = NULL;
+    replayingInput = false;
+
+    f64 frequency = (f64)SDL_GetPerformanceFrequency();
+    f64 total = (SDL_GetPerformanceCounter() - replayStart) / frequency;
+
+    //  LOG is compiled out of release builds, which is what replays are for
+    printf("Replayed %d frames in %.3fs\n", frame, total);
+    if (frame > 0) {
+        printf("\tAverage frame: %.3fms\n", total * 1000.0 / frame);
+        printf("\tWorst frame: %.3fms\n", worstFrameTime * 1000.0 / frequency);
+    }
+    printf("\t%s\n", desynced ? "DESYNCED" : "In sync");
+}
+
+}   //  namespace
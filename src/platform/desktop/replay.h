@@ -0,0 +1,64 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+/**
+    Deterministic input record / replay for performance regression runs
+
+    Recording writes the PRNG seed, the fixed update settings and, for every rendered frame, the
+    number of fixed updates that ran along with the SDL events that were queued for them. Replay
+    feeds those events back into eventQueue at the same frame indices and runs exactly the
+    recorded number of updates, so the timing accumulator and the wall clock never touch the
+    simulation. The window stays hidden and vsync is off so a trace runs as fast as the
+    machine allows.
+
+        game --record trace.abr
+        game --replay trace.abr
+
+    A trace is only valid for the build and the game data it was recorded with. Anything the
+    game reads outside of eventQueue (AB.system.getTicks, gamepad hotplug) will still diverge.
+*/
+
+#ifndef AB_REPLAY_H
+#define AB_REPLAY_H
+
+#include <vector>
+#include <string>
+
+namespace AB {
+
+b8 beginRecording(std::string const& filename);
+void recordFrame(std::vector<SDL_Event> const& events, u32 updates);
+void endRecording();
+
+b8 beginReplay(std::string const& filename);
+b8 replayFrame(std::vector<SDL_Event>& events, u32& updates);
+void checkReplaySync();
+void endReplay();
+
+extern b8 recordingInput;
+extern b8 replayingInput;
+
+}   //  namespace
+
+#endif // AB_REPLAY_H
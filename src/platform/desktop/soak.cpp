@@ -0,0 +1,290 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+#include "../../main/pch.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "soak.h"
+#include "../../main/mustard.h"
+#include "../../main/renderer/renderThread.h"
+
+namespace AB {
+
+extern Renderer renderer;
+extern Audio audio;
+extern Script script;
+
+extern AssetManager<Sprite> sprites;
+extern AssetManager<Shader> shaders;
+extern AssetManager<Font> fonts;
+extern AssetManager<Sound> sounds;
+extern AssetManager<Music> music;
+
+enum Category {
+    RESIDENT_MEMORY = 0,
+    LUA_HEAP,
+    SPRITES,
+    SHADERS,
+    FONTS,
+    SOUNDS,
+    MUSIC,
+    TEXTURES,
+    BUFFERS,
+    RENDER_QUEUES,
+    VOICES,
+    CATEGORY_MAX
+};
+
+//  thresholds are the allowed growth per hour, in bytes or objects
+static struct {
+    const char* name;
+    f64 threshold;
+} categories[CATEGORY_MAX] = {
+    {"rss", 8.0 * 1024.0 * 1024.0},
+    {"luaHeap", 2.0 * 1024.0 * 1024.0},
+    {"sprites", 1.0},
+    {"shaders", 1.0},
+    {"fonts", 1.0},
+    {"sounds", 1.0},
+    {"music", 1.0},
+    {"textures", 1.0},
+    {"buffers", 1.0},
+    {"renderQueues", 1024.0 * 1024.0},
+    {"voices", 1.0},
+};
+
+struct Sample {
+    f64 time;
+    f64 values[CATEGORY_MAX];
+};
+
+static std::vector<Sample> samples;
+static f64 soakDuration, sampleInterval, warmup = 60.0;
+static u32 startTicks, nextSampleTicks;
+static b8 configLoaded;
+
+b8 soaking = false;
+
+//  GL can't report how many objects exist, so probe names until a long run of unused ones.
+//  drivers hand out the lowest free name, so live objects stay densely packed
+static const u32 GL_PROBE_WINDOW = 1024;
+
+static u32 countGLObjects(b8 textures) {
+    u32 count = 0;
+    u32 misses = 0;
+
+    for (GLuint name = 1; misses < GL_PROBE_WINDOW; name++) {
+        if (textures ? glIsTexture(name) : glIsBuffer(name)) {
+            count++;
+            misses = 0;
+        } else {
+            misses++;
+        }
+    }
+
+    return count;
+}
+
+static f64 residentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return (f64)counters.WorkingSetSize;
+    }
+    return 0.0;
+#else
+    //  second field of statm is resident pages
+    long pages = 0;
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (file) {
+        if (fscanf(file, "%*s %ld", &pages) != 1) {
+            pages = 0;
+        }
+        fclose(file);
+    }
+    return (f64)pages * (f64)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+static void loadConfig() {
+    lua_State* luaVM = script.getVM();
+
+    lua_getglobal(luaVM, "soakConfig");
+    if (lua_istable(luaVM, -1)) {
+        lua_getfield(luaVM, -1, "warmup");
+        if (lua_isnumber(luaVM, -1)) {
+            warmup = lua_tonumber(luaVM, -1);
+        }
+        lua_pop(luaVM, 1);
+
+        for (i32 i = 0; i < CATEGORY_MAX; i++) {
+            lua_getfield(luaVM, -1, categories[i].name);
+            if (lua_isnumber(luaVM, -1)) {
+                categories[i].threshold = lua_tonumber(luaVM, -1);
+            }
+            lua_pop(luaVM, 1);
+        }
+    }
+    lua_pop(luaVM, 1);
+
+    configLoaded = true;
+}
+
+static void takeSample() {
+    Sample sample;
+    sample.time = (SDL_GetTicks() - startTicks) / 1000.0;
+
+    lua_State* luaVM = script.getVM();
+    sample.values[RESIDENT_MEMORY] = residentBytes();
+    sample.values[LUA_HEAP] = lua_gc(luaVM, LUA_GCCOUNT, 0) * 1024.0 + lua_gc(luaVM, LUA_GCCOUNTB, 0);
+
+    sample.values[SPRITES] = sprites.assetData.size();
+    sample.values[SHADERS] = shaders.assetData.size();
+    sample.values[FONTS] = fonts.assetData.size();
+    sample.values[SOUNDS] = sounds.assetData.size();
+    sample.values[MUSIC] = music.assetData.size();
+
+    syncRenderThread();
+    sample.values[TEXTURES] = countGLObjects(true);
+    sample.values[BUFFERS] = countGLObjects(false);
+
+    sample.values[RENDER_QUEUES] = 0.0;
+    for (auto& layer : renderer.layers) {
+        sample.values[RENDER_QUEUES] += layer.second->getReservedBytes();
+    }
+
+    sample.values[VOICES] = audio.countPlayingVoices();
+
+    samples.push_back(sample);
+}
+
+void beginSoak(f64 duration, f64 interval) {
+    soakDuration = duration;
+    sampleInterval = interval;
+
+    samples.clear();
+    configLoaded = false;
+    startTicks = SDL_GetTicks();
+    nextSampleTicks = startTicks;
+
+    soaking = true;
+}
+
+void updateSoak() {
+    if (!soaking) {
+        return;
+    }
+
+    //  soakConfig won't exist until the game's scripts have run
+    if (!configLoaded) {
+        loadConfig();
+    }
+
+    u32 ticks = SDL_GetTicks();
+    if (ticks >= nextSampleTicks) {
+        takeSample();
+        nextSampleTicks += (u32)(sampleInterval * 1000.0);
+    }
+
+    if (ticks - startTicks >= soakDuration * 1000.0) {
+        quit();
+    }
+}
+
+b8 endSoak() {
+    if (!soaking) {
+        return true;
+    }
+    soaking = false;
+
+    //  always end on a sample so the last interval counts
+    takeSample();
+
+    //  least squares fit of value against elapsed hours, skipping warmup
+    b8 passed = true;
+    u32 count = 0;
+    for (auto& sample : samples) {
+        if (sample.time >= warmup) {
+            count++;
+        }
+    }
+
+    printf("Soak test: %.0fs, %d samples (%d after warmup)\n", samples.back().time, (i32)samples.size(), count);
+    if (count < 2) {
+        printf("\tNot enough samples to measure growth\n");
+        return true;
+    }
+
+    printf("\t%-16s %16s %16s %16s %16s\n", "category", "first", "last", "slope/hour", "threshold");
+    for (i32 i = 0; i < CATEGORY_MAX; i++) {
+        f64 meanTime = 0.0, meanValue = 0.0;
+        f64 first = 0.0, last = 0.0;
+        b8 haveFirst = false;
+
+        for (auto& sample : samples) {
+            if (sample.time >= warmup) {
+                meanTime += sample.time / 3600.0;
+                meanValue += sample.values[i];
+
+                if (!haveFirst) {
+                    first = sample.values[i];
+                    haveFirst = true;
+                }
+                last = sample.values[i];
+            }
+        }
+        meanTime /= count;
+        meanValue /= count;
+
+        f64 covariance = 0.0, variance = 0.0;
+        for (auto& sample : samples) {
+            if (sample.time >= warmup) {
+                f64 dt = sample.time / 3600.0 - meanTime;
+                covariance += dt * (sample.values[i] - meanValue);
+                variance += dt * dt;
+            }
+        }
+        f64 slope = variance > 0.0 ? covariance / variance : 0.0;
+
+        b8 failed = slope > categories[i].threshold;
+        if (failed) {
+            passed = false;
+        }
+
+        printf("\t%-16s %16.0f %16.0f %16.1f %16.1f%s\n", categories[i].name, first, last,
+            slope, categories[i].threshold, failed ? "  FAIL" : "");
+    }
+
+    printf("\t%s\n", passed ? "PASSED" : "FAILED");
+
+    return passed;
+}
+
+}   //  namespace
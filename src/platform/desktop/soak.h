@@ -0,0 +1,56 @@
+/**
+
+zlib License
+
+(C) 2026 Andrew Krause
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+**/
+
+/**
+    Soak testing for slow memory and resource growth
+
+    Runs the game for a fixed duration (usually driven by an input replay) and samples resident
+    memory, the Lua heap, loaded asset counts, live GL textures and buffers, render queue capacity
+    and playing voices at a regular interval. At the end a least-squares growth slope is computed
+    for each category and compared against a per-hour threshold. Samples taken during warmup are
+    ignored so level loading doesn't read as a leak.
+
+        game --replay trace.abr --soak 14400 --soak-interval 30
+
+    Thresholds can be overridden from lua with a soakConfig table, ie
+
+        soakConfig = { warmup = 120, rss = 4194304, textures = 0 }
+*/
+
+#ifndef AB_SOAK_H
+#define AB_SOAK_H
+
+namespace AB {
+
+void beginSoak(f64 duration, f64 interval);
+void updateSoak();
+
+//  prints the report, returns false if any category grew faster than its threshold
+b8 endSoak();
+
+extern b8 soaking;
+
+}   //  namespace
+
+#endif // AB_SOAK_H
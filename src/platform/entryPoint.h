@@ -38,6 +38,9 @@ namespace AB {
 
 extern void quit();
 extern int run(Application *app);
+#ifndef __EMSCRIPTEN__
+extern void parseCommandLine(int argc, char* argv[]);
+#endif
 
 }   //  namespace
 
@@ -51,6 +54,11 @@ int main(int argc, char* argv[]) {
         return EXIT_FAILURE;
     }
 
+#ifndef __EMSCRIPTEN__
+    //    --record / --replay have to be known before the window is created
+    AB::parseCommandLine(argc, argv);
+#endif
+
     //    this has to be called before AB::startup() so we have a chance to add archives
     auto app = AB::createApplication();
 
@@ -0,0 +1,194 @@
+//  DynamicAtlas's bookkeeping runs without a GL context. these stand in for the parts of the
+//  engine it touches, so the real dynamicAtlas.cpp can be built on its own
+#define AB_PCH_H
+#define AB_SPRITE_H
+#define AB_RENDER_THREAD_H
+#define AB_RENDER_LAYER_H
+#define AB_TEXTURE_ARRAY_H
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "../main/math/math.h"
+#include "../main/renderer/image.h"
+#include "../main/core/log.h"
+
+typedef int GLint;
+enum { GL_MAX_TEXTURE_SIZE, GL_TEXTURE_2D, GL_TEXTURE0, GL_RGBA, GL_RGBA8, GL_UNSIGNED_BYTE, GL_UNPACK_ROW_LENGTH };
+static void glGetIntegerv(int, GLint* value) { *value = 4096; }
+static void glActiveTexture(int) {}
+static void glBindTexture(int, int) {}
+static void glPixelStorei(int, int) {}
+static void glTexImage2D(int, int, int, int, int, int, int, int, const void*) {}
+static void glTexSubImage2D(int, int, int, int, int, int, int, int, const void*) {}
+#define CALL_GL(stmt) stmt
+
+namespace AB {
+
+static void syncRenderThread() {}
+static void refreshTextureArray(unsigned int, u32, u32) {}
+
+struct Texture {
+    int glHandle = 0;
+    Texture(u32, u32) {}
+};
+
+struct RenderLayer {
+    struct { void invalidate() {} } static textureCache;
+};
+decltype(RenderLayer::textureCache) RenderLayer::textureCache;
+
+//  every sprite that's been deleted. the atlas should never touch one again
+static std::set<const void*> deadSprites;
+static bool touchedDeadSprite = false;
+
+class DynamicAtlas;
+static DynamicAtlas* testAtlas = nullptr;
+
+struct Sprite {
+    std::shared_ptr<Image> image;
+    std::shared_ptr<Texture> texture;
+    u32 atlasX, atlasY;
+
+    Sprite(u32 width, u32 height) : image(std::make_shared<Image>(width, height)) {
+        deadSprites.erase(this);
+    }
+    ~Sprite() {
+        deadSprites.insert(this);
+    }
+
+    void adopt(std::shared_ptr<Texture> texture, f32, f32, f32, f32) {
+        touchedDeadSprite = touchedDeadSprite || deadSprites.count(this) > 0;
+        this->texture = texture;
+    }
+
+    void release();
+
+    static u32 generation;
+};
+u32 Sprite::generation = 0;
+
+}   //  namespace
+
+#include "../main/renderer/dynamicAtlas.h"
+#include "../main/renderer/dynamicAtlas.cpp"
+
+namespace AB {
+
+//  what the real Sprite::release does with the atlas
+void Sprite::release() {
+    testAtlas->remove(this);
+    texture.reset();
+}
+
+}   //  namespace
+
+static void testReleasedSpritesLeaveAtlas() {
+    TestSuite suite("Dynamic atlas sprite lifetime");
+
+    AB::DynamicAtlas atlas(256, 1);
+    AB::testAtlas = &atlas;
+
+    std::vector<AB::Sprite*> sprites;
+    for (int i = 0; i < 12; i++) {
+        sprites.push_back(new AB::Sprite(20 + i * 3, 30 - i));
+        atlas.add(sprites.back());
+    }
+    suite.assert(atlas.getSpriteCount() == 12, "all sprites added");
+
+    //  one removed explicitly, then everything cleared the way AssetManager::clear does it,
+    //  except a few that are kept
+    atlas.remove(sprites[0]);
+    for (int i = 0; i < 8; i++) {
+        sprites[i]->release();
+        delete sprites[i];
+    }
+    suite.assert(atlas.getSpriteCount() == 4, "released sprites are no longer held");
+
+    atlas.compact(0.0f);
+    sprites.push_back(new AB::Sprite(200, 200));
+    atlas.add(sprites.back());
+    suite.assert(!AB::touchedDeadSprite, "compacting and repacking only moves live sprites");
+
+    for (size_t i = 8; i < sprites.size(); i++) {
+        sprites[i]->release();
+        delete sprites[i];
+    }
+    suite.assert(atlas.getSpriteCount() == 0, "atlas empty once everything is released");
+
+    AB::testAtlas = nullptr;
+}
+
+//  every sprite the atlas holds sits inside its page and clear of every other sprite on it
+static bool placementsValid(const std::vector<AB::Sprite*>& sprites, unsigned int pageSize) {
+    for (size_t i = 0; i < sprites.size(); i++) {
+        const AB::Sprite* a = sprites[i];
+        if (!a->texture) {
+            continue;
+        }
+        if (a->atlasX + a->image->width > pageSize || a->atlasY + a->image->height > pageSize) {
+            return false;
+        }
+        for (size_t j = i + 1; j < sprites.size(); j++) {
+            const AB::Sprite* b = sprites[j];
+            if (b->texture != a->texture) {
+                continue;
+            }
+            if (a->atlasX < b->atlasX + b->image->width && b->atlasX < a->atlasX + a->image->width &&
+                a->atlasY < b->atlasY + b->image->height && b->atlasY < a->atlasY + a->image->height) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void testSkylinePlacements() {
+    TestSuite suite("Dynamic atlas placement");
+
+    const unsigned int PAGE_SIZE = 256;
+    AB::DynamicAtlas atlas(PAGE_SIZE, 1);
+    AB::testAtlas = &atlas;
+
+    std::vector<AB::Sprite*> sprites;
+    unsigned int state = 2024;
+    auto addSprites = [&](int count) {
+        for (int i = 0; i < count; i++) {
+            state = state * 1664525 + 1013904223;
+            sprites.push_back(new AB::Sprite(4 + (state >> 8) % 60, 4 + (state >> 16) % 60));
+            atlas.add(sprites.back());
+        }
+    };
+
+    addSprites(80);
+    suite.assert(atlas.getSpriteCount() == 80, "all sprites placed");
+    suite.assert(atlas.getPageCount() > 1, "spilled onto more than one page");
+    suite.assert(placementsValid(sprites, PAGE_SIZE), "placements in bounds and apart");
+
+    //  punch holes in every page, repack them, then fill back in around what's left
+    for (size_t i = 0; i < sprites.size(); i += 2) {
+        sprites[i]->release();
+        delete sprites[i];
+        sprites[i] = nullptr;
+    }
+    sprites.erase(std::remove(sprites.begin(), sprites.end(), nullptr), sprites.end());
+    atlas.compact(0.0f);
+    suite.assert(placementsValid(sprites, PAGE_SIZE), "placements in bounds and apart after repacking");
+
+    addSprites(60);
+    suite.assert(placementsValid(sprites, PAGE_SIZE), "placements in bounds and apart after refilling");
+
+    for (AB::Sprite* sprite : sprites) {
+        sprite->release();
+        delete sprite;
+    }
+    AB::testAtlas = nullptr;
+}
+
+void testDynamicAtlas() {
+    testReleasedSpritesLeaveAtlas();
+    testSkylinePlacements();
+}
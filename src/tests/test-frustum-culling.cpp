@@ -0,0 +1,160 @@
+#include "../main/math/batchCulling.cpp"
+
+#include <chrono>
+
+static AB::Plane planeThroughOrigin(float x, float y, float z) {
+    AB::Vec3 normal(x, y, z);
+    return AB::Plane(AB::Vec3(0, 0, 0), AB::normalize(normal));
+}
+
+//  a perspective-ish frustum looking down -z, normals pointing in
+static AB::Frustum makeTestFrustum() {
+    AB::Frustum frustum;
+    frustum.plane[AB::Frustum::NEAR] = AB::Plane(AB::Vec3(0, 0, -1), AB::Vec3(0, 0, -1));
+    frustum.plane[AB::Frustum::FAR] = AB::Plane(AB::Vec3(0, 0, -100), AB::Vec3(0, 0, 1));
+    frustum.plane[AB::Frustum::RIGHT] = planeThroughOrigin(-1, 0, -0.5f);
+    frustum.plane[AB::Frustum::LEFT] = planeThroughOrigin(1, 0, -0.5f);
+    frustum.plane[AB::Frustum::TOP] = planeThroughOrigin(0, -1, -0.7f);
+    frustum.plane[AB::Frustum::BOTTOM] = planeThroughOrigin(0, 1, -0.7f);
+    return frustum;
+}
+
+static float randomRange(unsigned int& state, float low, float high) {
+    state = state * 1664525 + 1013904223;
+    return low + (high - low) * (float)(state >> 8) / (float)(1 << 24);
+}
+
+static void fillBoxes(AB::AABBArray& boxes, unsigned int count) {
+    unsigned int state = 777;
+    for (unsigned int i = 0; i < count; i++) {
+        float x = randomRange(state, -150, 150);
+        float y = randomRange(state, -150, 150);
+        float z = randomRange(state, -150, 20);
+        float size = randomRange(state, 0.1f, 8.0f);
+        boxes.minX.push_back(x - size);
+        boxes.minY.push_back(y - size);
+        boxes.minZ.push_back(z - size);
+        boxes.maxX.push_back(x + size);
+        boxes.maxY.push_back(y + size);
+        boxes.maxZ.push_back(z + size);
+    }
+}
+
+static void fillSpheres(AB::SphereArray& spheres, unsigned int count) {
+    unsigned int state = 4242;
+    for (unsigned int i = 0; i < count; i++) {
+        AB::Vec3 center(randomRange(state, -150, 150), randomRange(state, -150, 150), randomRange(state, -150, 20));
+        spheres.add(center, randomRange(state, 0.1f, 8.0f));
+    }
+}
+
+//  straight from the definition, one object and one plane at a time
+static bool referenceBox(AB::Frustum& frustum, const AB::AABBArray& boxes, unsigned int i) {
+    for (int p = 0; p < 6; p++) {
+        AB::Plane& plane = frustum.plane[p];
+        AB::Vec3 positive(
+            plane.normal.x >= 0 ? boxes.maxX[i] : boxes.minX[i],
+            plane.normal.y >= 0 ? boxes.maxY[i] : boxes.minY[i],
+            plane.normal.z >= 0 ? boxes.maxZ[i] : boxes.minZ[i]);
+        if (plane.getSignedDistanceToPoint(positive) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool referenceSphere(AB::Frustum& frustum, const AB::SphereArray& spheres, unsigned int i) {
+    AB::Vec3 center(spheres.x[i], spheres.y[i], spheres.z[i]);
+    for (int p = 0; p < 6; p++) {
+        if (frustum.plane[p].getSignedDistanceToPoint(center) < -spheres.radius[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void testBatchBoxCulling() {
+    TestSuite suite("Batch box culling");
+
+    AB::Frustum frustum = makeTestFrustum();
+
+    //  odd count so the scalar tail gets exercised too
+    AB::AABBArray boxes;
+    fillBoxes(boxes, 1003);
+
+    std::vector<AB::u32> simd, scalar(AB::visibilityWords(boxes.size()));
+    AB::cullBoxes(frustum, boxes, simd);
+    AB::cullBoxesScalar(frustum, boxes.minX.data(), boxes.minY.data(), boxes.minZ.data(),
+        boxes.maxX.data(), boxes.maxY.data(), boxes.maxZ.data(), boxes.size(), scalar.data());
+
+    bool simdMatches = true, scalarMatches = true;
+    unsigned int visible = 0;
+    for (unsigned int i = 0; i < boxes.size(); i++) {
+        bool expected = referenceBox(frustum, boxes, i);
+        simdMatches = simdMatches && AB::isVisible(simd.data(), i) == expected;
+        scalarMatches = scalarMatches && AB::isVisible(scalar.data(), i) == expected;
+        visible += expected;
+    }
+    suite.assert(simdMatches, "SIMD path matches reference");
+    suite.assert(scalarMatches, "scalar path matches reference");
+    suite.assert(visible > 0 && visible < boxes.size(), "test set straddles the frustum");
+    suite.assert((simd.back() >> (boxes.size() % 32)) == 0, "no bits past the end");
+}
+
+static void testBatchSphereCulling() {
+    TestSuite suite("Batch sphere culling");
+
+    AB::Frustum frustum = makeTestFrustum();
+
+    AB::SphereArray spheres;
+    fillSpheres(spheres, 1001);
+
+    std::vector<AB::u32> simd, scalar(AB::visibilityWords(spheres.size()));
+    AB::cullSpheres(frustum, spheres, simd);
+    AB::cullSpheresScalar(frustum, spheres.x.data(), spheres.y.data(), spheres.z.data(), spheres.radius.data(),
+        spheres.size(), scalar.data());
+
+    bool simdMatches = true, scalarMatches = true;
+    for (unsigned int i = 0; i < spheres.size(); i++) {
+        bool expected = referenceSphere(frustum, spheres, i);
+        simdMatches = simdMatches && AB::isVisible(simd.data(), i) == expected;
+        scalarMatches = scalarMatches && AB::isVisible(scalar.data(), i) == expected;
+    }
+    suite.assert(simdMatches, "SIMD path matches reference");
+    suite.assert(scalarMatches, "scalar path matches reference");
+}
+
+//  not pass/fail, just numbers to compare against
+static void benchmarkBatchCulling() {
+    const unsigned int COUNT = 100000;
+    const int RUNS = 20;
+
+    AB::Frustum frustum = makeTestFrustum();
+    AB::AABBArray boxes;
+    fillBoxes(boxes, COUNT);
+    std::vector<AB::u32> visibility(AB::visibilityWords(COUNT));
+
+    auto time = [&](bool simd) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int run = 0; run < RUNS; run++) {
+            if (simd) {
+                AB::cullBoxes(frustum, boxes, visibility);
+            } else {
+                AB::cullBoxesScalar(frustum, boxes.minX.data(), boxes.minY.data(), boxes.minZ.data(),
+                    boxes.maxX.data(), boxes.maxY.data(), boxes.maxZ.data(), COUNT, visibility.data());
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count() / RUNS;
+    };
+
+    double scalar = time(false);
+    double simd = time(true);
+    std::cout << "  " << COUNT << " boxes: scalar " << scalar << " ms, SIMD " << simd << " ms" << std::endl;
+}
+
+void testFrustumCulling() {
+    testBatchBoxCulling();
+    testBatchSphereCulling();
+    benchmarkBatchCulling();
+}
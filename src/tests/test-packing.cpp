@@ -0,0 +1,54 @@
+#include "../main/misc/packing.h"
+
+static void testHalfFloats() {
+    TestSuite suite("Half floats");
+
+    suite.assert(AB::floatToHalf(0.0f) == 0x0000, "0 packs to 0x0000");
+    suite.assert(AB::floatToHalf(-0.0f) == 0x8000, "-0 keeps its sign");
+    suite.assert(AB::floatToHalf(1.0f) == 0x3C00, "1 packs to 0x3C00");
+    suite.assert(AB::floatToHalf(-2.0f) == 0xC000, "-2 packs to 0xC000");
+    suite.assert(AB::floatToHalf(65504.0f) == 0x7BFF, "largest half");
+    suite.assert(AB::floatToHalf(70000.0f) == 0x7C00, "overflow goes to infinity");
+    suite.assert(AB::floatToHalf(5.9604645e-8f) == 0x0001, "smallest subnormal");
+    suite.assert(AB::floatToHalf(1.0f + 1.0f / 2048.0f) == 0x3C00, "halfway rounds to even");
+    suite.assert(AB::floatToHalf(1.0f + 3.0f / 2048.0f) == 0x3C02, "halfway rounds to even (up)");
+
+    //  everything a half can hold survives the round trip
+    bool roundTrip = true;
+    for (unsigned int h = 0; h < 0x7C00; h++) {
+        if (AB::floatToHalf(AB::halfToFloat(h)) != h || AB::floatToHalf(AB::halfToFloat(h | 0x8000)) != (h | 0x8000)) {
+            roundTrip = false;
+        }
+    }
+    suite.assert(roundTrip, "all finite halves round trip");
+
+    //  sprite sizes stay within half a unit up to 2048
+    bool sizes = true;
+    for (float f = 0.0f; f <= 2048.0f; f += 0.25f) {
+        if (std::fabs(AB::halfToFloat(AB::floatToHalf(f)) - f) > 0.5f) {
+            sizes = false;
+        }
+    }
+    suite.assert(sizes, "sprite sizes are close enough");
+}
+
+static void testUnormPacking() {
+    TestSuite suite("Unorm packing");
+
+    suite.assert(AB::packUnorm16(0.0f) == 0, "0 packs to 0");
+    suite.assert(AB::packUnorm16(1.0f) == 65535, "1 packs to 65535");
+    suite.assert(AB::packUnorm16(-0.5f) == 0, "clamps below 0");
+    suite.assert(AB::packUnorm16(1.5f) == 65535, "clamps above 1");
+    suite.assert(AB::packUnorm8(0.5f) == 128, "0.5 packs to 128");
+    suite.assert(AB::packUnorm8(1.0f) == 255, "1 packs to 255");
+
+    suite.assert(AB::packAngle(0.0f) == 0, "0 radians");
+    suite.assert(AB::packAngle((float)M_PI) == 32768, "half a turn");
+    suite.assert(AB::packAngle((float)(-M_PI / 2.0)) == 49152, "negative angles wrap");
+    suite.assert(AB::packAngle((float)(M_PI * 4.0)) == 0, "whole turns wrap to 0");
+}
+
+static void testPacking() {
+    testHalfFloats();
+    testUnormPacking();
+}
@@ -0,0 +1,181 @@
+//  emit() and update() only touch the particle system's own arrays. the sprite and render layer
+//  types the rest of it uses are renamed to stand-ins here, so the real particleSystem.cpp builds
+//  without a GL context
+#define AB_PCH_H
+#define AB_SPRITE_H
+#define AB_RENDER_LAYER_H
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "../main/math/math.h"
+#include "../main/renderer/camera.h"
+#include "../main/core/log.h"
+#include "../main/math/random.cpp"
+
+#define Sprite ParticleSprite
+#define RenderLayer ParticleRenderLayer
+
+namespace AB {
+
+struct RenderLayer {
+    struct Quad {};
+    std::vector<Quad> quadBatch;
+};
+
+struct Sprite {
+    std::shared_ptr<int> texture;
+    u32 width = 1, height = 1;
+
+    void uploadToGPU() {}
+    RenderLayer::Quad makeQuad(Vec3, f32, Vec2, Vec4) const { return RenderLayer::Quad(); }
+};
+
+template<class T>
+struct AssetManager {
+    T sprite;
+    T* get(u32) { return &sprite; }
+};
+
+AssetManager<Sprite> sprites;
+
+}   //  namespace
+
+#include "../main/renderer/particleSystem.h"
+#include "../main/renderer/particleSystem.cpp"
+
+#undef Sprite
+#undef RenderLayer
+
+class TestParticleSystem : public AB::ParticleSystem {
+    public:
+        using AB::ParticleSystem::ParticleSystem;
+        using AB::ParticleSystem::integrate;
+        using AB::ParticleSystem::integrateScalar;
+        using AB::ParticleSystem::posX;
+        using AB::ParticleSystem::posY;
+        using AB::ParticleSystem::posZ;
+        using AB::ParticleSystem::velX;
+        using AB::ParticleSystem::velY;
+        using AB::ParticleSystem::velZ;
+        using AB::ParticleSystem::angle;
+        using AB::ParticleSystem::lifetimeRemaining;
+};
+
+//  a still particle marked by its x position, living exactly lifetime ticks
+static AB::ParticleParameters markedParticle(float marker, unsigned int lifetime) {
+    AB::ParticleParameters parameters;
+    parameters.pos = AB::Vec3(marker, 0.0f, 0.0f);
+    parameters.vel = AB::Vec3(0.0f, 0.0f, 0.0f);
+    parameters.acceleration = AB::Vec3(0.0f, 0.0f, 0.0f);
+    parameters.startScale = parameters.endScale = 1.0f;
+    parameters.minAngle = parameters.maxAngle = 0.0f;
+    parameters.minRotation = parameters.maxRotation = 0.0f;
+    parameters.startSprite = parameters.endSprite = 0;
+    parameters.minLifetime = parameters.maxLifetime = lifetime;
+    return parameters;
+}
+
+static std::vector<float> liveMarkers(const TestParticleSystem& system) {
+    std::vector<float> markers(system.posX.begin(), system.posX.begin() + system.getCount());
+    std::sort(markers.begin(), markers.end());
+    return markers;
+}
+
+static void testSwapRemoveKeepsParticlesPacked() {
+    TestSuite suite("Particle swap remove");
+
+    const unsigned int lifetimes[] = { 3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5, 8 };
+    TestParticleSystem system(16, 1);
+    for (unsigned int i = 0; i < 12; i++) {
+        system.emit(markedParticle((float)i, lifetimes[i]));
+    }
+
+    bool counted = true, packed = true, survivors = true;
+    for (unsigned int tick = 1; tick <= 10; tick++) {
+        system.update();
+
+        std::vector<float> expected;
+        for (unsigned int i = 0; i < 12; i++) {
+            if (lifetimes[i] > tick) {
+                expected.push_back((float)i);
+            }
+        }
+        counted = counted && system.getCount() == expected.size();
+        for (unsigned int i = 0; i < system.getCount(); i++) {
+            packed = packed && system.lifetimeRemaining[i] > 0;
+        }
+        survivors = survivors && liveMarkers(system) == expected;
+    }
+    suite.assert(counted, "count matches the particles still alive");
+    suite.assert(packed, "only live particles below count");
+    suite.assert(survivors, "the right particles survive");
+    suite.assert(!system.active, "inactive once every particle has expired");
+}
+
+static void testEmitReplacesRoundRobinWhenFull() {
+    TestSuite suite("Particle emit when full");
+
+    TestParticleSystem system(4, 1);
+    for (unsigned int i = 0; i < 4; i++) {
+        system.emit(markedParticle((float)i, 100));
+    }
+    suite.assert(system.getCount() == 4, "filled");
+
+    system.emit(markedParticle(10.0f, 100), 2);
+    suite.assert(system.getCount() == 4, "count stays at the maximum");
+    suite.assert(system.posX[0] == 10.0f && system.posX[1] == 10.0f && system.posX[2] == 2.0f && system.posX[3] == 3.0f,
+        "oldest two replaced");
+
+    system.emit(markedParticle(20.0f, 100), 3);
+    suite.assert(system.posX[0] == 20.0f && system.posX[1] == 10.0f && system.posX[2] == 20.0f && system.posX[3] == 20.0f,
+        "replacement wraps around");
+}
+
+static void testSIMDUpdateMatchesScalar() {
+    TestSuite suite("Particle SIMD update");
+
+    //  an odd count, so the last group of four is part garbage
+    TestParticleSystem simd(64, 99), scalar(64, 99);
+    unsigned int state = 31337;
+    auto next = [&](float low, float high) {
+        state = state * 1664525 + 1013904223;
+        return low + (high - low) * (float)(state >> 8) / (float)(1 << 24);
+    };
+    for (unsigned int i = 0; i < 37; i++) {
+        AB::ParticleParameters parameters = markedParticle(next(-10, 10), 1000);
+        parameters.pos.y = next(-10, 10);
+        parameters.pos.z = next(-10, 10);
+        parameters.vel = AB::Vec3(next(-1, 1), next(-1, 1), next(-1, 1));
+        parameters.acceleration = AB::Vec3(next(-0.1f, 0.1f), next(-0.1f, 0.1f), next(-0.1f, 0.1f));
+        parameters.dampening = next(0.9f, 1.0f);
+        parameters.minRotation = -0.2f;
+        parameters.maxRotation = 0.2f;
+        parameters.minLifetime = 500;
+        simd.emit(parameters);
+        scalar.emit(parameters);
+    }
+
+    for (int tick = 0; tick < 100; tick++) {
+        simd.integrate();
+        scalar.integrateScalar();
+    }
+
+    unsigned int count = simd.getCount();
+    auto same = [&](const std::vector<float>& a, const std::vector<float>& b) {
+        return memcmp(a.data(), b.data(), count * sizeof(float)) == 0;
+    };
+    suite.assert(same(simd.posX, scalar.posX) && same(simd.posY, scalar.posY) && same(simd.posZ, scalar.posZ), "positions match");
+    suite.assert(same(simd.velX, scalar.velX) && same(simd.velY, scalar.velY) && same(simd.velZ, scalar.velZ), "velocities match");
+    suite.assert(same(simd.angle, scalar.angle), "angles match");
+    suite.assert(memcmp(simd.lifetimeRemaining.data(), scalar.lifetimeRemaining.data(), count * sizeof(int)) == 0, "lifetimes match");
+}
+
+void testParticleSystem() {
+    testSwapRemoveKeepsParticlesPacked();
+    testEmitReplacesRoundRobinWhenFull();
+    testSIMDUpdateMatchesScalar();
+}
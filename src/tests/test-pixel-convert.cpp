@@ -0,0 +1,116 @@
+#include "../main/renderer/pixelConvert.cpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+//  what tga.cpp used to do, swap then premultiply in floats
+static void referenceConvert(AB::u8* data, unsigned int count) {
+    for (unsigned int i = 0; i < count; i++) {
+        AB::u8* pixel = &data[i * 4];
+        AB::u8 temp = pixel[0];
+        pixel[0] = pixel[2];
+        pixel[2] = temp;
+
+        float a = pixel[3] / 255.0f;
+        for (int c = 0; c < 3; c++) {
+            pixel[c] = (AB::u8)round((pixel[c] / 255.0f) * a * 255.0f);
+        }
+    }
+}
+
+static std::vector<AB::u8> randomPixels(unsigned int count) {
+    std::vector<AB::u8> pixels(count * 4);
+    unsigned int state = 12345;
+    for (auto& byte : pixels) {
+        state = state * 1664525 + 1013904223;
+        byte = (AB::u8)(state >> 24);
+    }
+    return pixels;
+}
+
+static void testPremultiply() {
+    TestSuite suite("integer premultiply");
+
+    bool matches = true;
+    for (unsigned int color = 0; color < 256; color++) {
+        for (unsigned int alpha = 0; alpha < 256; alpha++) {
+            AB::u8 expected = (AB::u8)round((color / 255.0f) * (alpha / 255.0f) * 255.0f);
+            matches = matches && AB::premultiply(color, alpha) == expected;
+        }
+    }
+    suite.assert(matches, "matches float premultiply for every color and alpha");
+}
+
+static void testConvertBGRA() {
+    TestSuite suite("BGRA conversion");
+
+    //  odd counts to catch the scalar tail
+    const unsigned int counts[] = { 1, 3, 4, 7, 64, 1001 };
+    bool simdMatches = true;
+    bool scalarMatches = true;
+    for (unsigned int count : counts) {
+        std::vector<AB::u8> source = randomPixels(count);
+        std::vector<AB::u8> expected = source;
+        referenceConvert(expected.data(), count);
+
+        std::vector<AB::u8> simd(count * 4), scalar(count * 4);
+        AB::convertBGRA(simd.data(), source.data(), count);
+        AB::convertBGRAScalar(scalar.data(), source.data(), count);
+
+        simdMatches = simdMatches && simd == expected;
+        scalarMatches = scalarMatches && scalar == expected;
+    }
+    suite.assert(simdMatches, "SIMD path matches reference");
+    suite.assert(scalarMatches, "scalar path matches reference");
+
+    std::vector<AB::u8> inPlace = randomPixels(37);
+    std::vector<AB::u8> expected = inPlace;
+    referenceConvert(expected.data(), 37);
+    AB::convertBGRA(inPlace.data(), inPlace.data(), 37);
+    suite.assert(inPlace == expected, "converts in place");
+
+    AB::u8 bgr[6] = { 1, 2, 3, 4, 5, 6 };
+    AB::u8 rgba[8];
+    AB::convertBGR(rgba, bgr, 2);
+    const AB::u8 expandedBGR[8] = { 3, 2, 1, 255, 6, 5, 4, 255 };
+    suite.assert(memcmp(rgba, expandedBGR, 8) == 0, "BGR expands to opaque RGBA");
+}
+
+//  not pass/fail, just numbers to compare against
+static void benchmarkPixelConvert() {
+    const unsigned int COUNT = 1024 * 1024;
+    const int RUNS = 20;
+
+    std::vector<AB::u8> source = randomPixels(COUNT);
+    std::vector<AB::u8> destination(COUNT * 4);
+
+    auto time = [&](int path) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int run = 0; run < RUNS; run++) {
+            if (path == 0) {
+                memcpy(destination.data(), source.data(), COUNT * 4);
+                referenceConvert(destination.data(), COUNT);
+            } else if (path == 1) {
+                AB::convertBGRAScalar(destination.data(), source.data(), COUNT);
+            } else {
+                AB::convertBGRA(destination.data(), source.data(), COUNT);
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count() / RUNS;
+    };
+
+    double reference = time(0);
+    double scalar = time(1);
+    double simd = time(2);
+    std::cout << "  " << COUNT << " pixels: copy+swap+float " << reference << " ms, scalar " << scalar
+        << " ms, SIMD " << simd << " ms" << std::endl;
+}
+
+void testPixelConvert() {
+    testPremultiply();
+    testConvertBGRA();
+    benchmarkPixelConvert();
+}
@@ -0,0 +1,112 @@
+#include "../main/misc/radixSort.h"
+
+#include <algorithm>
+
+struct TestQuad {
+    float z;
+    int textureID;
+};
+
+static bool cmpDepth(const TestQuad& a, const TestQuad& b) {
+    if (a.z == b.z) {
+        return a.textureID < b.textureID;
+    } else {
+        return a.z < b.z;
+    }
+}
+
+static void testSortableFloats() {
+    TestSuite suite("Sortable floats");
+
+    float values[] = {-1000.0f, -2.5f, -1.0f, -0.001f, 0.0f, 0.001f, 1.0f, 2.5f, 1000.0f};
+    bool ordered = true;
+    for (int i = 0; i < 8; i++) {
+        ordered = ordered && AB::floatToSortable(values[i]) < AB::floatToSortable(values[i + 1]);
+    }
+    suite.assert(ordered, "ordering preserved");
+    suite.assert(AB::floatToSortable(-0.0f) == AB::floatToSortable(0.0f), "-0 == +0");
+}
+
+static void testRadixSortMatchesStableSort() {
+    TestSuite suite("Radix sort");
+
+    std::vector<TestQuad> quads;
+    unsigned int state = 12345;
+    for (int i = 0; i < 5000; i++) {
+        state = state * 1664525 + 1013904223;
+        TestQuad quad;
+        quad.z = (float)((int)(state >> 8) % 64 - 32) * 0.25f;
+        quad.textureID = (state >> 4) % 12;
+        quads.push_back(quad);
+    }
+
+    std::vector<AB::SortKey> keys(quads.size());
+    std::vector<AB::SortKey> scratch;
+    for (unsigned int i = 0; i < quads.size(); i++) {
+        keys[i].key = ((AB::u64)AB::floatToSortable(quads[i].z) << 32) | (AB::u32)quads[i].textureID;
+        keys[i].index = i;
+    }
+    AB::radixSort(keys, scratch);
+
+    //  tag each quad with its submission order so stability can be checked too
+    std::vector<std::pair<TestQuad, unsigned int>> expected;
+    for (unsigned int i = 0; i < quads.size(); i++) {
+        expected.push_back(std::make_pair(quads[i], i));
+    }
+    std::stable_sort(expected.begin(), expected.end(), [](const std::pair<TestQuad, unsigned int>& a, const std::pair<TestQuad, unsigned int>& b) {
+        return cmpDepth(a.first, b.first);
+    });
+
+    bool matches = true;
+    for (unsigned int i = 0; i < quads.size(); i++) {
+        matches = matches && keys[i].index == expected[i].second;
+    }
+    suite.assert(matches, "matches std::stable_sort with depth comparator");
+}
+
+static void testInsertionSort() {
+    TestSuite suite("Insertion sort");
+
+    //  sorted, then a few neighbours swapped, like depths from one frame to the next
+    std::vector<AB::SortKey> keys(1000);
+    for (unsigned int i = 0; i < keys.size(); i++) {
+        keys[i].key = i / 2;
+        keys[i].index = i;
+    }
+    for (unsigned int i = 10; i < keys.size(); i += 97) {
+        std::swap(keys[i].key, keys[i + 3].key);
+    }
+    std::vector<AB::SortKey> expected = keys;
+    std::stable_sort(expected.begin(), expected.end(), [](const AB::SortKey& a, const AB::SortKey& b) {
+        return a.key < b.key;
+    });
+
+    bool finished = AB::insertionSort(keys.data(), keys.size(), keys.size());
+    bool matches = true;
+    for (unsigned int i = 0; i < keys.size(); i++) {
+        matches = matches && keys[i].index == expected[i].index;
+    }
+    suite.assert(finished, "nearly sorted input stays within budget");
+    suite.assert(matches, "matches std::stable_sort");
+
+    //  reversed input blows the budget but must still hold every key once
+    for (unsigned int i = 0; i < keys.size(); i++) {
+        keys[i].key = keys.size() - i;
+        keys[i].index = i;
+    }
+    finished = AB::insertionSort(keys.data(), keys.size(), 100);
+    std::vector<bool> seen(keys.size(), false);
+    bool permutation = true;
+    for (auto& key : keys) {
+        permutation = permutation && !seen[key.index] && key.key == keys.size() - key.index;
+        seen[key.index] = true;
+    }
+    suite.assert(!finished, "gives up on reversed input");
+    suite.assert(permutation, "keys intact after giving up");
+}
+
+void testRadixSort() {
+    testSortableFloats();
+    testRadixSortMatchesStableSort();
+    testInsertionSort();
+}
@@ -0,0 +1,215 @@
+//  times loading a texture from an archive both ways it can be stored: as the TGA the artist
+//  saved, and as the blob the asset compiler writes (textureFormat.h). the real Image and
+//  decodeTGA run against a stand-in FileSystem. there's no GL context in here, so the upload is
+//  the copy of the bytes Texture::init would hand to glTexImage2D
+#define AB_PCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../vendor/zlib-1.3.1/zlib.h"
+
+typedef unsigned char GLubyte;
+
+#include "../main/renderer/image.cpp"
+#include "../main/renderer/tga.cpp"
+
+namespace AB {
+
+//  assets come out of an archive that was inflated when it was opened, so loadAsset just points
+//  into it like FileSystem::loadAssetFromArchive does
+FileSystem fileSystem;
+static const std::vector<u8>* archivedAsset = nullptr;
+
+b8 FileSystem::startup() { return true; }
+void FileSystem::shutdown() {}
+
+DataObject FileSystem::loadAsset(const std::string& filename, b8 forceLocal) {
+    return DataObject(const_cast<u8*>(archivedAsset->data()), archivedAsset->size());
+}
+
+}   //  namespace
+
+//  transparent background with flat discs and a soft edged gradient, roughly what sprites and
+//  UI pages look like. BGRA, not premultiplied
+static std::vector<AB::u8> makeArtwork(unsigned int size) {
+    std::vector<AB::u8> pixels(size * size * 4, 0);
+    unsigned int state = 4242;
+    for (int disc = 0; disc < 24; disc++) {
+        state = state * 1664525 + 1013904223;
+        float cx = (float)((state >> 8) % size);
+        state = state * 1664525 + 1013904223;
+        float cy = (float)((state >> 8) % size);
+        float radius = size * (0.03f + 0.02f * (disc % 5));
+        AB::u8 b = (AB::u8)(state >> 24), g = (AB::u8)(state >> 16), r = (AB::u8)(state >> 8);
+
+        for (unsigned int y = 0; y < size; y++) {
+            for (unsigned int x = 0; x < size; x++) {
+                float distance = sqrtf((x - cx) * (x - cx) + (y - cy) * (y - cy));
+                if (distance > radius) {
+                    continue;
+                }
+                AB::u8* pixel = &pixels[(y * size + x) * 4];
+                bool soft = disc % 3 == 0;
+                pixel[0] = soft ? (AB::u8)(x * 255 / size) : b;
+                pixel[1] = soft ? (AB::u8)(y * 255 / size) : g;
+                pixel[2] = r;
+                pixel[3] = soft ? (AB::u8)(255 * (1.0f - distance / radius)) : 255;
+            }
+        }
+    }
+    return pixels;
+}
+
+//  opaque and noisy, like a photo or painted background, where RLE gets nowhere
+static std::vector<AB::u8> makePhoto(unsigned int size) {
+    std::vector<AB::u8> pixels(size * size * 4);
+    unsigned int state = 1717;
+    for (unsigned int i = 0; i < size * size; i++) {
+        state = state * 1664525 + 1013904223;
+        unsigned int x = i % size, y = i / size;
+        pixels[i * 4 + 0] = (AB::u8)(x * 255 / size + (state >> 29));
+        pixels[i * 4 + 1] = (AB::u8)(y * 255 / size + (state >> 26 & 7));
+        pixels[i * 4 + 2] = (AB::u8)((x + y) * 127 / size + (state >> 23 & 7));
+        pixels[i * 4 + 3] = 255;
+    }
+    return pixels;
+}
+
+//  32 bit RLE TGA, bottom up, the way paint programs save them
+static std::vector<AB::u8> encodeTGA(const std::vector<AB::u8>& pixels, unsigned int size) {
+    std::vector<AB::u8> tga(18, 0);
+    tga[2] = 10;
+    tga[12] = size & 0xFF;
+    tga[13] = size >> 8;
+    tga[14] = size & 0xFF;
+    tga[15] = size >> 8;
+    tga[16] = 32;
+    tga[17] = 0x08;
+
+    for (unsigned int row = 0; row < size; row++) {
+        const AB::u32* line = (const AB::u32*)&pixels[(size - 1 - row) * size * 4];
+        for (unsigned int x = 0; x < size;) {
+            unsigned int run = 1;
+            while (x + run < size && run < 128 && line[x + run] == line[x]) {
+                run++;
+            }
+            if (run > 1) {
+                tga.push_back(0x80 | (run - 1));
+                tga.insert(tga.end(), (const AB::u8*)&line[x], (const AB::u8*)&line[x] + 4);
+                x += run;
+                continue;
+            }
+
+            unsigned int raw = 1;
+            while (x + raw < size && raw < 128 && !(x + raw + 1 < size && line[x + raw] == line[x + raw + 1])) {
+                raw++;
+            }
+            tga.push_back(raw - 1);
+            tga.insert(tga.end(), (const AB::u8*)&line[x], (const AB::u8*)&line[x + raw]);
+            x += raw;
+        }
+    }
+    return tga;
+}
+
+//  what the asset compiler writes for it, one mip level
+static std::vector<AB::u8> encodeBlob(const std::vector<AB::u8>& tga, unsigned int size) {
+    AB::u32 width, height, bpp;
+    AB::u8* rgba = AB::decodeTGA(tga.data(), tga.size(), "", width, height, bpp);
+
+    AB::TextureHeader header;
+    memcpy(header.magic, AB::TEXTURE_MAGIC, sizeof(header.magic));
+    header.version = AB::TEXTURE_VERSION;
+    header.width = width;
+    header.height = height;
+    header.mipLevels = 1;
+    header.reserved = 0;
+
+    std::vector<AB::u8> blob(sizeof(header) + width * height * 4);
+    memcpy(blob.data(), &header, sizeof(header));
+    memcpy(blob.data() + sizeof(header), rgba, width * height * 4);
+    delete[] rgba;
+    return blob;
+}
+
+static std::vector<AB::u8> deflateAsset(const std::vector<AB::u8>& asset) {
+    uLongf size = compressBound(asset.size());
+    std::vector<AB::u8> compressed(size);
+    compress2(compressed.data(), &size, asset.data(), asset.size(), Z_DEFAULT_COMPRESSION);
+    compressed.resize(size);
+    return compressed;
+}
+
+static void testTextureLoad() {
+    TestSuite suite("Texture blobs");
+
+    std::vector<AB::u8> artwork = makeArtwork(64);
+    std::vector<AB::u8> tga = encodeTGA(artwork, 64);
+    std::vector<AB::u8> blob = encodeBlob(tga, 64);
+
+    AB::archivedAsset = &tga;
+    AB::Image fromTGA("test.tga");
+    AB::archivedAsset = &blob;
+    AB::Image fromBlob("test.tga");
+
+    suite.assert(fromBlob.width == 64 && fromBlob.height == 64 && fromBlob.mipLevels == 1, "blob header read");
+    suite.assert(memcmp(fromTGA.data, fromBlob.data, 64 * 64 * 4) == 0, "blob pixels match decoded TGA");
+}
+
+//  not pass/fail, just numbers to compare against. per load: inflating the asset's share of the
+//  archive, building the Image, and copying out what would be uploaded
+static void benchmarkTextureLoad(const char* name, std::vector<AB::u8> (*makeImage)(unsigned int)) {
+    const unsigned int sizes[] = { 256, 1024, 2048 };
+    const int RUNS = 10;
+
+    for (unsigned int size : sizes) {
+        std::vector<AB::u8> tga = encodeTGA(makeImage(size), size);
+        std::vector<AB::u8> blob = encodeBlob(tga, size);
+        std::vector<AB::u8> texture(size * size * 4);
+
+        auto time = [&](const std::vector<AB::u8>& asset, double& inflateTime, double& loadTime, size_t& archived) {
+            std::vector<AB::u8> compressed = deflateAsset(asset);
+            std::vector<AB::u8> inflated(asset.size());
+            archived = compressed.size();
+
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int run = 0; run < RUNS; run++) {
+                uLongf inflatedSize = inflated.size();
+                uncompress(inflated.data(), &inflatedSize, compressed.data(), compressed.size());
+            }
+            auto middle = std::chrono::high_resolution_clock::now();
+            AB::archivedAsset = &inflated;
+            for (int run = 0; run < RUNS; run++) {
+                AB::Image image("benchmark.tga");
+                memcpy(texture.data(), image.data, image.imageSize);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+
+            inflateTime = std::chrono::duration<double, std::milli>(middle - start).count() / RUNS;
+            loadTime = std::chrono::duration<double, std::milli>(end - middle).count() / RUNS;
+        };
+
+        double tgaInflate, tgaLoad, blobInflate, blobLoad;
+        size_t tgaArchived, blobArchived;
+        time(tga, tgaInflate, tgaLoad, tgaArchived);
+        time(blob, blobInflate, blobLoad, blobArchived);
+
+        std::cout << "  " << size << "x" << size << " " << name << " TGA: " << tgaArchived / 1024 << " KB archived, inflate " << tgaInflate
+            << " ms + load " << tgaLoad << " ms = " << tgaInflate + tgaLoad << " ms" << std::endl;
+        std::cout << "  " << size << "x" << size << " " << name << " blob: " << blobArchived / 1024 << " KB archived, inflate " << blobInflate
+            << " ms + load " << blobLoad << " ms = " << blobInflate + blobLoad << " ms" << std::endl;
+    }
+    AB::archivedAsset = nullptr;
+}
+
+void testTextureBlobs() {
+    testTextureLoad();
+    benchmarkTextureLoad("sprites", makeArtwork);
+    benchmarkTextureLoad("photo", makePhoto);
+}
@@ -33,6 +33,13 @@ class TestSuite {
 #include "test-vector.cpp"
 #include "test-matrix.cpp"
 #include "test-plane-intersection.cpp"
+#include "test-frustum-culling.cpp"
+#include "test-radix-sort.cpp"
+#include "test-packing.cpp"
+#include "test-pixel-convert.cpp"
+#include "test-texture-load.cpp"
+#include "test-dynamic-atlas.cpp"
+#include "test-particle-system.cpp"
 #include "test-project-build.cpp"
 
 int main(int argc, char* argv[]) {
@@ -42,6 +49,13 @@ int main(int argc, char* argv[]) {
     testVector();
     testMatrix();
     testPlaneIntersection();
+    testFrustumCulling();
+    testRadixSort();
+    testPacking();
+    testPixelConvert();
+    testTextureBlobs();
+    testDynamicAtlas();
+    testParticleSystem();
     testProjectBuild();
 
     std::cout << "============= Tests complete ============" << std::endl;